@@ -206,6 +206,71 @@ typedef struct ipasir2_option {
 } ipasir2_option;
 
 
+/**
+ * @enum ipasir2_redundancy
+ * @brief Kinds of redundancy of a clause with respect to the formula of the solver.
+ *
+ * @var ipasir2_redundancy::IPASIR2_R_UNKNOWN
+ *  @brief The solver does not specify the kind of redundancy.
+ *
+ * @var ipasir2_redundancy::IPASIR2_R_EQUIVALENT
+ *  @brief The clause is implied by the formula, e.g., derived by resolution.
+ *  @details Adding the clause preserves the models of the formula, so it can be shared with other solvers working on the same formula.
+ *
+ * @var ipasir2_redundancy::IPASIR2_R_SATISFIABLE
+ *  @brief The clause preserves satisfiability only, e.g., a blocked clause or a clause derived by symmetry breaking.
+ *  @details Such clauses must not be shared with other solvers, since clauses of this kind from different sources can contradict each other.
+ */
+typedef enum ipasir2_redundancy {
+    IPASIR2_R_UNKNOWN = 0,
+    IPASIR2_R_EQUIVALENT,
+    IPASIR2_R_SATISFIABLE
+} ipasir2_redundancy;
+
+
+/**
+ * @struct ipasir2_clause_meta
+ * @brief Standard clause metadata passed through the proofmeta parameters.
+ * @details If the standard option "ipasir.proofmeta.clause" is set to 1, the proofmeta pointer passed to the export and delete
+ *      callbacks points to an ipasir2_clause_meta struct describing the clause (or is nullptr if the solver has no metadata for it),
+ *      and a proofmeta pointer given to ipasir2_add() or ipasir2_add_clauses() which is not nullptr is read as ipasir2_clause_meta.
+ *      Solvers can use the metadata of added clauses, e.g. to place imported clauses in the right tier of their clause database.
+ *      The struct is only valid during the callback or function call, receivers copy the values they need.
+ *      Fields which are unknown to the sender are zero.
+ *
+ * @var ipasir2_clause_meta::id
+ *  @brief Unique identifier of the clause in the sending solver, or 0.
+ *  @details For clauses given to ipasir2_add() or ipasir2_add_clauses(), the solver refers to the clause by this identifier
+ *           in the \p hints of the clauses derived from it.
+ *
+ * @var ipasir2_clause_meta::lbd
+ *  @brief Literal block distance (glue) of the clause when it was learned or last updated, or 0.
+ *
+ * @var ipasir2_clause_meta::activity
+ *  @brief Solver specific activity score of the clause, higher is more active, or 0.
+ *
+ * @var ipasir2_clause_meta::redundancy
+ *  @brief Kind of redundancy of the clause.
+ *
+ * @var ipasir2_clause_meta::hints
+ *  @brief Identifiers of the clauses from which a learned clause was derived, or nullptr.
+ *  @details The antecedents are given in the order in which they become unit in a reverse unit propagation check of the clause,
+ *           as in the hints of an LRAT proof step. Negative identifiers mark resolution candidates of a RAT step.
+ *           Solvers which do not produce hints leave the field nullptr.
+ *
+ * @var ipasir2_clause_meta::hints_count
+ *  @brief Number of identifiers in \p hints.
+ */
+typedef struct ipasir2_clause_meta {
+    uint64_t id;
+    int32_t lbd;
+    float activity;
+    ipasir2_redundancy redundancy;
+    int64_t const* hints;
+    int32_t hints_count;
+} ipasir2_clause_meta;
+
+
 /**
  * @brief Returns the name and the version of the incremental SAT solver library.
  *
@@ -246,6 +311,31 @@ IPASIR_API ipasir2_errorcode ipasir2_init(void** solver);
 IPASIR_API ipasir2_errorcode ipasir2_release(void* solver);
 
 
+/**
+ * @brief Creates a copy of the given solver instance.
+ * @details The copy is a new, independent solver instance with the same formula as \p solver,
+ *          including its forgettable clauses, and with the option values, learned clauses,
+ *          variable phases and scores which \p solver has at the time of the call, as far as the
+ *          solver can copy them. Use this to fork an instance after an expensive loading or
+ *          preprocessing phase, e.g. to explore alternatives on several threads.
+ *          The copy does not inherit callbacks registered with the ipasir2_set_*() functions,
+ *          nor the model or failed assumptions of the last ipasir2_solve() call.
+ *          Both instances must be released with ipasir2_release().
+ *
+ * @param[in] solver The solver instance to copy.
+ * @param[out] clone After successful execution, \p *clone points to the created solver instance.
+ *
+ * @return IPASIR2_E_OK if the function call was successful.
+ *         IPASIR2_E_UNSUPPORTED if the solver does not implement cloning.
+ *         IPASIR2_E_INVALID_STATE if the solver is in the SOLVING state.
+ *
+ * Required state of \p solver: CONFIG <= state < SOLVING
+ * State of \p solver after the function returns: unchanged
+ * State of \p *clone after the function returns: CONFIG if \p solver is in CONFIG, else INPUT
+ */
+IPASIR_API ipasir2_errorcode ipasir2_clone(void* solver, void** clone);
+
+
 /** 
  * @brief Returns the configuration options which are supported by the solver.
  * @details The array contains all available options for the solver.
@@ -270,6 +360,8 @@ IPASIR_API ipasir2_errorcode ipasir2_options(void* solver, ipasir2_option const*
  * @brief Returns the handle to the option with the given name.
  * @details The handle can be used to set the option value.
  *          Convenience function for searching the option array returned by ipasir2_options().
+ *          The search is linear in the number of options, so clients looking up options repeatedly
+ *          should resolve the handles once per solver instance and keep them.
  *
  * @param[in] solver The solver instance.
  * @param[in] name The option identifier.
@@ -328,6 +420,35 @@ inline ipasir2_errorcode ipasir2_get_option_handle(void* solver, char const* nam
 IPASIR_API ipasir2_errorcode ipasir2_set_option(void* solver, ipasir2_option const* handle, int64_t value, int64_t index);
 
 
+/**
+ * @brief Sets the values of an indexed option for many indices at once.
+ * @details Bulk variant of ipasir2_set_option() for indexed options, e.g., for seeding the initial phases of all variables.
+ *          If \p indices is not nullptr, values[i] is set for index indices[i], for each i < \p count.
+ *          If \p indices is nullptr, the values are given densely over a contiguous range, i.e., values[i] is set for index \p first + i.
+ *          The effect is the same as calling ipasir2_set_option() for each index/value pair in order.
+ *          All values are checked before any of them is set: if one value is outside the allowed range,
+ *          the function returns IPASIR2_E_INVALID_OPTION_VALUE and no value is set.
+ *
+ * @param[in] solver The solver instance.
+ * @param[in] handle The option handle of an indexed option.
+ * @param[in] values Array of \p count option values.
+ * @param[in] indices Array of \p count indices, or nullptr for the contiguous range starting at \p first.
+ * @param[in] first The first index of the range if \p indices is nullptr, ignored otherwise.
+ * @param[in] count The number of values.
+ *
+ * @return IPASIR2_E_OK if the function call was successful.
+ *         IPASIR2_E_UNSUPPORTED if the solver does not implement bulk option setting.
+ *         IPASIR2_E_INVALID_ARGUMENT if the option is not indexed.
+ *         IPASIR2_E_INVALID_OPTION_VALUE if an option value is outside the allowed range.
+ *         IPASIR2_E_INVALID_STATE if the option is not allowed to be set in the current state.
+ *
+ * Required state of \p solver: <= handle->max_state
+ * State of \p solver after the function returns: same as before
+ */
+IPASIR_API ipasir2_errorcode ipasir2_set_option_array(void* solver, ipasir2_option const* handle, int64_t const* values,
+    int64_t const* indices, int64_t first, int32_t count);
+
+
 /**
  * @brief Adds a clause to the formula.
  * @details The \p clause is a pointer to an array of literals of length \p len.
@@ -336,6 +457,7 @@ IPASIR_API ipasir2_errorcode ipasir2_set_option(void* solver, ipasir2_option con
  *          Literals are encoded as (non-zero) integers as in the DIMACS format.
  *          \p proofmeta points to a struct containing additional proof metadata.
  *          The struct type and its semantics are specific to the selected proof method and are specified in the configuration options..
+ *          With the standard option "ipasir.proofmeta.clause" set, \p proofmeta is nullptr or points to an ipasir2_clause_meta struct.
  *
  * @param[in] solver The solver instance.
  * @param[in] clause The clause of length \p len to be added.
@@ -352,6 +474,37 @@ IPASIR_API ipasir2_errorcode ipasir2_set_option(void* solver, ipasir2_option con
 IPASIR_API ipasir2_errorcode ipasir2_add(void* solver, int32_t const* clause, int32_t len, int32_t forgettable, void* proofmeta);
 
 
+/**
+ * @brief Adds a batch of clauses to the formula.
+ * @details Bulk variant of ipasir2_add() for handing over a whole slice of a formula in one call.
+ *          The clauses are given in compressed sparse row layout: \p literals is a flat array containing
+ *          the literals of all clauses one after another, and clause i consists of the literals
+ *          literals[offsets[i]] to literals[offsets[i+1] - 1]. Thus, \p offsets contains \p count + 1
+ *          non-decreasing entries, and literals[offsets[0]] is the first literal of the first clause.
+ *          Each clause is treated as if it had been added by a separate call to ipasir2_add()
+ *          with the given \p forgettable flag, in the order in which the clauses appear in the batch.
+ *          If \p proofmeta is not nullptr, it points to an array of \p count proof metadata pointers,
+ *          one per clause, with the same semantics as the \p proofmeta parameter of ipasir2_add().
+ *
+ * @param[in] solver The solver instance.
+ * @param[in] literals Flat array of the literals of all clauses in the batch.
+ * @param[in] offsets Array of \p count + 1 offsets into \p literals delimiting the clauses.
+ * @param[in] count The number of clauses in the batch.
+ * @param[in] forgettable If forgettable is set to 0, the solver guarantees to satisfy the clauses in any potentially found model.
+ *         Otherwise, the clauses are forgettable, i.e., the solver may remove them from the formula.
+ * @param[in] proofmeta Array of \p count opaque pointers to proof metadata, or nullptr.
+ *
+ * @return IPASIR2_E_OK if the function call was successful.
+ *         IPASIR2_E_UNSUPPORTED if the solver does not implement bulk clause addition.
+ *         IPASIR2_E_INVALID_ARGUMENT if \p offsets is not non-decreasing.
+ *
+ * Required state of \p solver: state <= SOLVING
+ * State of \p solver after the function returns: if state < SOLVING then INPUT else SOLVING
+ */
+IPASIR_API ipasir2_errorcode ipasir2_add_clauses(void* solver, int32_t const* literals, int32_t const* offsets, int32_t count,
+    int32_t forgettable, void* const* proofmeta);
+
+
 /**
  * @brief Solves the formula with specified clauses under the given assumption \p literals.
  * @details If the formula is satisfiable, the output parameter \p result is set to 10 and the state of the solver is changed to SAT.
@@ -401,6 +554,31 @@ IPASIR_API ipasir2_errorcode ipasir2_solve(void* solver, int* result, int32_t co
 IPASIR_API ipasir2_errorcode ipasir2_value(void* solver, int32_t lit, int32_t* result);
 
 
+/**
+ * @brief Writes the truth values of a range of variables in the found satisfying assignment to a caller-provided array.
+ * @details Vectorized variant of ipasir2_value() for reading back a whole model in one call.
+ *          The function can only be used if the solver is in state SAT.
+ *          For each variable v in the range \p first to \p first + \p count - 1, the value of v is written to
+ *          result[v - first]: 1 if v is satisfied by the model, -1 if -v is satisfied by the model, and 0 if the found
+ *          assignment is satisfying for both v and -v. The values agree with those returned by ipasir2_value().
+ *          Variables which do not occur in the formula may be reported with any value.
+ *
+ * @param[in] solver The solver instance.
+ * @param[in] first The first variable of the range (greater than zero).
+ * @param[in] count The number of variables in the range.
+ * @param[out] result Caller-provided array of at least \p count elements.
+ *
+ * @return IPASIR2_E_OK if the function call was successful.
+ *         IPASIR2_E_UNSUPPORTED if the solver does not implement vectorized model extraction.
+ *         IPASIR2_E_INVALID_STATE if the solver is not in the SAT state.
+ *         IPASIR2_E_INVALID_ARGUMENT if \p first is not a valid variable or \p count is negative.
+ *
+ * Required state of \p solver: SAT
+ * State of \p solver after the function returns: SAT
+ */
+IPASIR_API ipasir2_errorcode ipasir2_values(void* solver, int32_t first, int32_t count, int8_t* result);
+
+
 /**
  * @brief Checks if the given assumption literal was used to prove the unsatisfiability in the last SAT search.
  * @details The function can only be used if the solver is in state UNSAT.
@@ -426,6 +604,30 @@ IPASIR_API ipasir2_errorcode ipasir2_value(void* solver, int32_t lit, int32_t* r
 IPASIR_API ipasir2_errorcode ipasir2_failed(void* solver, int32_t lit, int* result);
 
 
+/**
+ * @brief Returns the assumption literals which were used to prove the unsatisfiability in the last SAT search.
+ * @details Array variant of ipasir2_failed() for retrieving the whole unsatisfiable core in one call.
+ *          The function can only be used if the solver is in state UNSAT.
+ *          The output parameter \p *size is set to the number of failed assumption literals, i.e., the number of
+ *          assumption literals for which ipasir2_failed() sets its result to 1. The first min(\p *size, \p capacity)
+ *          of these literals are written to \p core, in no particular order.
+ *          To query the size of the core before allocating a buffer, call the function with \p capacity set to zero.
+ *
+ * @param[in] solver The solver instance.
+ * @param[out] core Caller-provided array of at least \p capacity elements. May be nullptr if \p capacity is zero.
+ * @param[in] capacity The number of elements available in \p core.
+ * @param[out] size After successful execution, \p *size is set to the number of failed assumption literals.
+ *
+ * @return IPASIR2_E_OK if the function call was successful.
+ *         IPASIR2_E_UNSUPPORTED if the solver does not implement core retrieval.
+ *         IPASIR2_E_INVALID_STATE if the solver is not in the UNSAT state.
+ *
+ * Required state of \p solver: UNSAT
+ * State of \p solver after the function returns: UNSAT
+ */
+IPASIR_API ipasir2_errorcode ipasir2_failed_core(void* solver, int32_t* core, int32_t capacity, int32_t* size);
+
+
 /**
  * @brief Sets a callback function used to indicate a termination requirement to the solver.
  * @details The solver periodically calls this function while being in SOLVING state.
@@ -453,12 +655,14 @@ IPASIR_API ipasir2_errorcode ipasir2_set_terminate(void* solver, void* data,
  * @brief Sets a callback function for receiving learned clauses from the solver.
  * @details The solver calls this \p callback function in the SOLVING state for each learned clause that is allowed to be exported.
  *          A learned clause is allowed to be exported if its size is less than \p max_length or if \p max_length is -1.
+ *          Solvers supporting the standard option "ipasir.export.max_lbd" additionally restrict exported clauses by their LBD.
  *          The argument \p data is passed on to the \p callback function as its first parameter.
  *          The remaining parameters are \p clause, a pointer to an integer array containing the learned clause, and \p len, the length of the learned clause.
  *          The \p clause pointer is only guaranteed to be valid only during the execution of the \p callback function.
  *          If this callback setter is called several times on the \p solver, only the most recent call is taken into account.
  *          \p proofmeta points to a struct containing additional proof metadata.
  *          The struct type and its semantics are specific to the selected proof method and are specified in the configuration options.
+ *          With the standard option "ipasir.proofmeta.clause" set, \p proofmeta is nullptr or points to an ipasir2_clause_meta struct.
  *
  * @param[in] solver The solver instance.
  * @param[in] data Opaque pointer passed to the callback function as the first parameter. May be nullptr.
@@ -472,10 +676,41 @@ IPASIR_API ipasir2_errorcode ipasir2_set_terminate(void* solver, void* data,
  * Required state of \p solver: <= SOLVING
  * State of \p solver after the function returns: same as before
  */
-IPASIR_API ipasir2_errorcode ipasir2_set_export(void* solver, void* data, int max_length, 
+IPASIR_API ipasir2_errorcode ipasir2_set_export(void* solver, void* data, int max_length,
     void (*callback)(void* data, int32_t const* clause, int32_t len, void* proofmeta));
 
 
+/**
+ * @brief Sets a callback function for receiving learned clauses from the solver in batches.
+ * @details This function is a batched variant of ipasir2_set_export(). Instead of calling the callback function once
+ *          per learned clause, the solver collects the learned clauses which are allowed to be exported and passes
+ *          them to \p callback in a single call at flush points of its choice, e.g. at restarts or every few conflicts.
+ *          Clauses collected during a call to ipasir2_solve() are passed to \p callback before that call returns.
+ *          The clauses are given in the same layout as in ipasir2_add_clauses(): the literals of clause i are
+ *          \p literals[\p offsets[i]] to \p literals[\p offsets[i+1] - 1], for i = 0 .. \p count - 1.
+ *          \p proofmeta is either nullptr or an array of \p count pointers to the proof metadata of the clauses,
+ *          as for ipasir2_set_export().
+ *          All arrays are only guaranteed to be valid during the execution of the \p callback function.
+ *          The callback set by this function and the callback set by ipasir2_set_export() exclude each other:
+ *          setting one of them disables the other.
+ *          If this callback setter is called several times on the \p solver, only the most recent call is taken into account.
+ *
+ * @param[in] solver The solver instance.
+ * @param[in] data Opaque pointer passed to the callback function as the first parameter. May be nullptr.
+ * @param[in] max_length Specifies the maximum length of the learned clauses to be returned.
+ *                       If this parameter is -1 the solver returns all learned clauses.
+ * @param[in] callback The batched clause export callback function. If this parameter is nullptr, the callback is disabled.
+ *
+ * @return IPASIR2_E_OK if the function call was successful.
+ *         IPASIR2_E_UNSUPPORTED if the solver does not support batched clause export.
+ *
+ * Required state of \p solver: <= SOLVING
+ * State of \p solver after the function returns: same as before
+ */
+IPASIR_API ipasir2_errorcode ipasir2_set_export_batch(void* solver, void* data, int max_length,
+    void (*callback)(void* data, int32_t const* literals, int32_t const* offsets, int32_t count, void* const* proofmeta));
+
+
 /**
  * @brief Sets a callback function for notifying about deleted clauses.
  *        The solver calls this function in the SOLVING state for each clause that is deleted from the formula.
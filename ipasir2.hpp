@@ -0,0 +1,371 @@
+/**
+ * \file
+ *
+ * Header-only C++17 wrapper for IPASIR-2.
+ *
+ * ipasir2::solver owns a solver instance and reports errors by throwing ipasir2::error.
+ * Clauses and assumptions are passed as ipasir2::literals, a non-owning view which is
+ * implicitly constructed from std::vector, std::array, C arrays and initializer lists.
+ *
+ * Callbacks are bound by template: for each functor type (or member function), the wrapper
+ * instantiates a trampoline with the signature of the C callback which calls the functor
+ * directly, so the call can be inlined and no std::function is allocated. Functors are
+ * bound by reference and must stay alive as long as they are set.
+ *
+ * Example:
+ *
+ *     ipasir2::solver s;
+ *     s.add({ 1, 2 });
+ *     s.add({ -1, 2 });
+ *     int polls = 0;
+ *     auto terminate = [&polls]() { return ++polls > 1000; };
+ *     s.set_terminate(terminate);
+ *     if (s.solve({ -2 }) == ipasir2::result::unsat) {
+ *         bool failed = s.failed(-2);
+ *     }
+ */
+
+#ifndef INTERFACE_IPASIR2_HPP_
+#define INTERFACE_IPASIR2_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ipasir2.h"
+#include "ipasir2_optional.h"
+
+
+namespace ipasir2 {
+
+/**
+ * @brief Exception thrown by the wrapper if an IPASIR-2 function returns an error code.
+ */
+class error : public std::runtime_error {
+public:
+    error(ipasir2_errorcode code, char const* function)
+        : std::runtime_error(std::string(function) + "() returned error code " + std::to_string(static_cast<int>(code))), m_code(code) {}
+
+    ipasir2_errorcode code() const noexcept {
+        return m_code;
+    }
+
+private:
+    ipasir2_errorcode m_code;
+};
+
+inline void check(ipasir2_errorcode code, char const* function) {
+    if (code != IPASIR2_E_OK) {
+        throw error(code, function);
+    }
+}
+
+
+/**
+ * @brief Non-owning view of contiguous literals, a C++17 stand-in for std::span<int32_t const>.
+ */
+class literals {
+public:
+    constexpr literals() noexcept = default;
+
+    constexpr literals(int32_t const* data, size_t size) noexcept : m_data(data), m_size(size) {}
+
+    // the list must outlive the view, which holds for arguments of function calls
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winit-list-lifetime"
+#endif
+    literals(std::initializer_list<int32_t> list) noexcept : m_data(list.begin()), m_size(list.size()) {}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+    template<size_t N>
+    constexpr literals(int32_t const (&array)[N]) noexcept : m_data(array), m_size(N) {}
+
+    // any contiguous range of int32_t with data() and size(), e.g. std::vector or std::array
+    template<typename Range, typename = std::enable_if_t<
+        std::is_convertible<decltype(std::declval<Range const&>().data()), int32_t const*>::value &&
+        std::is_convertible<decltype(std::declval<Range const&>().size()), size_t>::value>>
+    literals(Range const& range) noexcept : m_data(range.data()), m_size(range.size()) {}
+
+    constexpr int32_t const* data() const noexcept { return m_data; }
+    constexpr size_t size() const noexcept { return m_size; }
+    constexpr bool empty() const noexcept { return m_size == 0; }
+    constexpr int32_t const* begin() const noexcept { return m_data; }
+    constexpr int32_t const* end() const noexcept { return m_data + m_size; }
+    constexpr int32_t operator[](size_t i) const noexcept { return m_data[i]; }
+
+private:
+    int32_t const* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+
+enum class result {
+    unknown = 0,
+    sat = 10,
+    unsat = 20
+};
+
+
+/**
+ * @brief C callbacks calling a functor of type F, which is passed as the data pointer.
+ * @details The solver's callback setters use these, they can also be passed to the C API directly.
+ */
+template<typename F>
+struct trampoline {
+    static int terminate(void* data) {
+        return static_cast<int>((*static_cast<F*>(data))());
+    }
+
+    // export and delete
+    static void clause(void* data, int32_t const* clause, int32_t len, void* proofmeta) {
+        (*static_cast<F*>(data))(literals(clause, len), proofmeta);
+    }
+
+    static void batch(void* data, int32_t const* lits, int32_t const* offsets, int32_t count, void* const* proofmeta) {
+        (*static_cast<F*>(data))(literals(lits, count > 0 ? offsets[count] : 0), literals(offsets, count + 1), proofmeta);
+    }
+
+    static void import(void* data) {
+        (*static_cast<F*>(data))();
+    }
+
+    static void fixed(void* data, int32_t lit) {
+        (*static_cast<F*>(data))(lit);
+    }
+};
+
+/**
+ * @brief C callbacks calling the member function Method of an object of type T, which is passed as the data pointer.
+ */
+template<auto Method, typename T>
+struct member_trampoline {
+    static int terminate(void* data) {
+        return static_cast<int>((static_cast<T*>(data)->*Method)());
+    }
+
+    static void fixed(void* data, int32_t lit) {
+        (static_cast<T*>(data)->*Method)(lit);
+    }
+};
+
+
+/**
+ * @brief Owning wrapper of an IPASIR-2 solver instance.
+ */
+class solver {
+public:
+    solver() {
+        check(ipasir2_init(&m_solver), "ipasir2_init");
+    }
+
+    ~solver() {
+        if (m_solver != nullptr) {
+            ipasir2_release(m_solver);
+        }
+    }
+
+    solver(solver const&) = delete;
+    solver& operator=(solver const&) = delete;
+
+    solver(solver&& other) noexcept : m_solver(std::exchange(other.m_solver, nullptr)) {}
+
+    solver& operator=(solver&& other) noexcept {
+        if (this != &other) {
+            if (m_solver != nullptr) {
+                ipasir2_release(m_solver);
+            }
+            m_solver = std::exchange(other.m_solver, nullptr);
+        }
+        return *this;
+    }
+
+    /**
+     * Independent copy of the instance made by ipasir2_clone(), with the formula and learned state
+     * but without the callbacks. Throws ipasir2::error with IPASIR2_E_UNSUPPORTED if the solver cannot clone.
+     */
+    solver clone() const {
+        void* copy = nullptr;
+        check(ipasir2_clone != nullptr ? ipasir2_clone(m_solver, &copy) : IPASIR2_E_UNSUPPORTED, "ipasir2_clone");
+        return solver(copy);
+    }
+
+    // the underlying solver instance, for calling the C API directly
+    void* handle() const noexcept {
+        return m_solver;
+    }
+
+    static std::string signature() {
+        char const* signature = nullptr;
+        check(ipasir2_signature(&signature), "ipasir2_signature");
+        return signature;
+    }
+
+    void set_option(ipasir2_option const* handle, int64_t value, int64_t index = 0) {
+        check(ipasir2_set_option(m_solver, handle, value, index), "ipasir2_set_option");
+    }
+
+    void set_option(char const* name, int64_t value, int64_t index = 0) {
+        ipasir2_option const* handle = nullptr;
+        check(ipasir2_get_option_handle(m_solver, name, &handle), "ipasir2_get_option_handle");
+        set_option(handle, value, index);
+    }
+
+    void add(literals clause, bool forgettable = false, void* proofmeta = nullptr) {
+        check(ipasir2_add(m_solver, clause.data(), static_cast<int32_t>(clause.size()), forgettable, proofmeta), "ipasir2_add");
+    }
+
+    /**
+     * Adds the clauses given in CSR layout (see ipasir2_add_clauses()), where \p offsets has one entry more than there are clauses.
+     * Falls back to one ipasir2_add() call per clause if the solver does not support bulk addition.
+     */
+    void add_clauses(literals lits, literals offsets, bool forgettable = false) {
+        int32_t count = offsets.empty() ? 0 : static_cast<int32_t>(offsets.size() - 1);
+        ipasir2_errorcode ret = IPASIR2_E_UNSUPPORTED;
+        if (ipasir2_add_clauses != nullptr) {
+            ret = ipasir2_add_clauses(m_solver, lits.data(), offsets.data(), count, forgettable, nullptr);
+        }
+        if (ret == IPASIR2_E_UNSUPPORTED) {
+            for (int32_t i = 0; i < count; ++i) {
+                add(literals(lits.data() + offsets[i], offsets[i + 1] - offsets[i]), forgettable);
+            }
+            return;
+        }
+        check(ret, "ipasir2_add_clauses");
+    }
+
+    result solve(literals assumptions = {}) {
+        int res = 0;
+        check(ipasir2_solve(m_solver, &res, assumptions.data(), static_cast<int32_t>(assumptions.size())), "ipasir2_solve");
+        return static_cast<result>(res);
+    }
+
+    // value of \p lit in the model: lit if true, -lit if false, 0 if the variable is not assigned
+    int32_t value(int32_t lit) const {
+        int32_t res = 0;
+        check(ipasir2_value(m_solver, lit, &res), "ipasir2_value");
+        return res;
+    }
+
+    bool failed(int32_t lit) const {
+        int res = 0;
+        check(ipasir2_failed(m_solver, lit, &res), "ipasir2_failed");
+        return res != 0;
+    }
+
+    /**
+     * Failed literals among the given assumptions of the last solve call.
+     * Uses ipasir2_failed_core() and falls back to ipasir2_failed() if the solver does not support it.
+     */
+    std::vector<int32_t> core(literals assumptions) const {
+        std::vector<int32_t> result;
+        int32_t size = 0;
+        ipasir2_errorcode ret = IPASIR2_E_UNSUPPORTED;
+        if (ipasir2_failed_core != nullptr) {
+            ret = ipasir2_failed_core(m_solver, nullptr, 0, &size);
+        }
+        if (ret == IPASIR2_E_OK) {
+            result.resize(size);
+            check(ipasir2_failed_core(m_solver, result.data(), size, &size), "ipasir2_failed_core");
+            return result;
+        }
+        if (ret != IPASIR2_E_UNSUPPORTED) {
+            check(ret, "ipasir2_failed_core");
+        }
+        for (int32_t lit : assumptions) {
+            if (failed(lit)) {
+                result.push_back(lit);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Callback setters. \p callback is any functor with the signature given below, it is called through
+     * a trampoline generated for its type and must outlive its registration. Temporaries are rejected.
+     *  - terminate: bool(), returns true to stop the search
+     *  - export, delete: void(literals clause, void* proofmeta)
+     *  - export batch: void(literals literals, literals offsets, void* const* proofmeta)
+     *  - import: void(), may call add() once
+     *  - fixed: void(int32_t lit)
+     */
+    template<typename F>
+    void set_terminate(F& callback) {
+        check(ipasir2_set_terminate(m_solver, data(callback), trampoline<F>::terminate), "ipasir2_set_terminate");
+    }
+
+    template<typename F>
+    void set_export(F& callback, int max_length = -1) {
+        check(ipasir2_set_export(m_solver, data(callback), max_length, trampoline<F>::clause), "ipasir2_set_export");
+    }
+
+    template<typename F>
+    void set_export_batch(F& callback, int max_length = -1) {
+        check(ipasir2_set_export_batch != nullptr ? ipasir2_set_export_batch(m_solver, data(callback), max_length, trampoline<F>::batch)
+            : IPASIR2_E_UNSUPPORTED, "ipasir2_set_export_batch");
+    }
+
+    template<typename F>
+    void set_delete(F& callback) {
+        check(ipasir2_set_delete(m_solver, data(callback), trampoline<F>::clause), "ipasir2_set_delete");
+    }
+
+    template<typename F>
+    void set_import(F& callback) {
+        check(ipasir2_set_import(m_solver, data(callback), trampoline<F>::import), "ipasir2_set_import");
+    }
+
+    template<typename F>
+    void set_fixed(F& callback) {
+        check(ipasir2_set_fixed(m_solver, data(callback), trampoline<F>::fixed), "ipasir2_set_fixed");
+    }
+
+    template<typename F> void set_terminate(F const&&) = delete;
+    template<typename F> void set_export(F const&&, int = -1) = delete;
+    template<typename F> void set_export_batch(F const&&, int = -1) = delete;
+    template<typename F> void set_delete(F const&&) = delete;
+    template<typename F> void set_import(F const&&) = delete;
+    template<typename F> void set_fixed(F const&&) = delete;
+
+    /**
+     * Binds a member function of \p object, e.g. set_terminate<&my_class::should_stop>(obj).
+     */
+    template<auto Method, typename T>
+    void set_terminate(T& object) {
+        check(ipasir2_set_terminate(m_solver, data(object), member_trampoline<Method, T>::terminate), "ipasir2_set_terminate");
+    }
+
+    template<auto Method, typename T>
+    void set_fixed(T& object) {
+        check(ipasir2_set_fixed(m_solver, data(object), member_trampoline<Method, T>::fixed), "ipasir2_set_fixed");
+    }
+
+    void clear_terminate() { check(ipasir2_set_terminate(m_solver, nullptr, nullptr), "ipasir2_set_terminate"); }
+    void clear_export() { check(ipasir2_set_export(m_solver, nullptr, -1, nullptr), "ipasir2_set_export"); }
+    void clear_delete() { check(ipasir2_set_delete(m_solver, nullptr, nullptr), "ipasir2_set_delete"); }
+    void clear_import() { check(ipasir2_set_import(m_solver, nullptr, nullptr), "ipasir2_set_import"); }
+    void clear_fixed() { check(ipasir2_set_fixed(m_solver, nullptr, nullptr), "ipasir2_set_fixed"); }
+
+private:
+    explicit solver(void* handle) noexcept : m_solver(handle) {}
+
+    // the data pointer of a callback, F is const for const functors and the trampoline casts it back to F*
+    template<typename F>
+    static void* data(F& callback) noexcept {
+        return const_cast<void*>(static_cast<void const*>(std::addressof(callback)));
+    }
+
+    void* m_solver = nullptr;
+};
+
+}  // namespace ipasir2
+
+#endif  // INTERFACE_IPASIR2_HPP_
@@ -0,0 +1,252 @@
+/**
+ * \file
+ *
+ * Asynchronous solving on top of the C++ wrapper (ipasir2.hpp).
+ *
+ * ipasir2::thread_pool runs solve calls on a fixed number of worker threads, so that many solver
+ * instances can be driven without blocking one caller thread per ipasir2_solve().
+ * ipasir2::async_solver owns a solver instance and starts solve calls on a pool. Each call returns
+ * an ipasir2::solve_future, which delivers the result and can cancel the call. Cancellation is
+ * cooperative: the async_solver owns the terminate callback of its instance, which reports the
+ * cancellation at the next poll, and the future then completes with result::unknown.
+ *
+ * Between solve calls the instance is accessed through async_solver::get(), e.g. to add clauses
+ * or to read the model. This must not overlap with a running solve call.
+ *
+ * Example:
+ *
+ *     ipasir2::thread_pool pool(4);
+ *     ipasir2::async_solver s(pool);
+ *     s.get().add({ 1, 2 });
+ *     ipasir2::solve_future f = s.solve({ -1 });
+ *     if (f.wait_for(std::chrono::seconds(10)) != std::future_status::ready) {
+ *         f.cancel();
+ *     }
+ *     ipasir2::result res = f.get();
+ */
+
+#ifndef INTERFACE_IPASIR2_ASYNC_HPP_
+#define INTERFACE_IPASIR2_ASYNC_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ipasir2.hpp"
+
+
+namespace ipasir2 {
+
+/**
+ * @brief Fixed number of worker threads executing tasks in FIFO order.
+ * @details The destructor runs the remaining tasks and joins the workers.
+ */
+class thread_pool {
+public:
+    explicit thread_pool(unsigned threads = std::thread::hardware_concurrency()) {
+        threads = threads > 0 ? threads : 1;
+        for (unsigned i = 0; i < threads; ++i) {
+            m_workers.emplace_back([this]() { work(); });
+        }
+    }
+
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopped = true;
+        }
+        m_wakeup.notify_all();
+        for (std::thread& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    thread_pool(thread_pool const&) = delete;
+    thread_pool& operator=(thread_pool const&) = delete;
+
+    void post(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+        }
+        m_wakeup.notify_one();
+    }
+
+    size_t size() const noexcept {
+        return m_workers.size();
+    }
+
+private:
+    void work() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wakeup.wait(lock, [this]() { return m_stopped || !m_tasks.empty(); });
+                if (m_tasks.empty()) {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    std::deque<std::function<void()>> m_tasks;
+    std::vector<std::thread> m_workers;
+    bool m_stopped = false;
+};
+
+
+/**
+ * @brief Result of an asynchronous solve call, which can be waited for and cancelled.
+ * @details get() returns the result or rethrows the ipasir2::error of the solve call.
+ * Copies refer to the same solve call.
+ */
+class solve_future {
+public:
+    solve_future() = default;
+
+    result get() const {
+        return m_result.get();
+    }
+
+    bool valid() const noexcept {
+        return m_result.valid();
+    }
+
+    bool ready() const {
+        return m_result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    void wait() const {
+        m_result.wait();
+    }
+
+    template<typename Rep, typename Period>
+    std::future_status wait_for(std::chrono::duration<Rep, Period> const& timeout) const {
+        return m_result.wait_for(timeout);
+    }
+
+    /**
+     * Requests termination of the solve call, which then completes with result::unknown.
+     * Does not wait for the call to return. A call which has not started yet is skipped.
+     */
+    void cancel() noexcept {
+        if (m_cancelled) {
+            m_cancelled->store(true, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    friend class async_solver;
+
+    solve_future(std::shared_future<result> res, std::shared_ptr<std::atomic<bool>> cancelled)
+        : m_result(std::move(res)), m_cancelled(std::move(cancelled)) {}
+
+    std::shared_future<result> m_result;
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
+
+
+/**
+ * @brief Solver instance whose solve calls run on a thread_pool.
+ * @details At most one solve call per instance is pending at a time. The terminate callback of
+ * the instance is reserved for cancellation. The destructor cancels a pending call and waits for it.
+ */
+class async_solver {
+public:
+    explicit async_solver(thread_pool& pool) : m_pool(pool) {
+        try {
+            m_solver.set_terminate<&async_solver::poll>(*this);
+        }
+        catch (error const& e) {
+            // without terminate support, cancel() only skips solve calls which have not started
+            if (e.code() != IPASIR2_E_UNSUPPORTED) {
+                throw;
+            }
+        }
+    }
+
+    ~async_solver() {
+        if (m_pending.valid()) {
+            m_pending.cancel();
+            m_pending.wait();
+        }
+    }
+
+    async_solver(async_solver const&) = delete;
+    async_solver& operator=(async_solver const&) = delete;
+
+    // the solver instance for synchronous calls between solve calls
+    solver& get() noexcept {
+        return m_solver;
+    }
+
+    /**
+     * Starts a solve call under the given assumptions, which are copied.
+     * If given, \p done is called with the result on the worker thread before the future becomes ready.
+     * Throws ipasir2::error with IPASIR2_E_INVALID_STATE if the previous solve call is still pending.
+     */
+    solve_future solve(literals assumptions = {}, std::function<void(result)> done = {}) {
+        if (m_pending.valid() && !m_pending.ready()) {
+            throw error(IPASIR2_E_INVALID_STATE, "async_solver::solve");
+        }
+        auto promise = std::make_shared<std::promise<result>>();
+        auto cancelled = std::make_shared<std::atomic<bool>>(false);
+        m_pending = solve_future(promise->get_future().share(), cancelled);
+        std::vector<int32_t> copy(assumptions.begin(), assumptions.end());
+        m_pool.post([this, promise, cancelled, copy = std::move(copy), done = std::move(done)]() {
+            result res = result::unknown;
+            if (!cancelled->load(std::memory_order_relaxed)) {
+                m_cancelled.store(cancelled.get(), std::memory_order_release);
+                try {
+                    res = m_solver.solve(copy);
+                }
+                catch (...) {
+                    m_cancelled.store(nullptr, std::memory_order_relaxed);
+                    promise->set_exception(std::current_exception());
+                    return;
+                }
+                m_cancelled.store(nullptr, std::memory_order_relaxed);
+            }
+            try {
+                if (done) {
+                    done(res);
+                }
+            }
+            catch (...) {
+                promise->set_exception(std::current_exception());
+                return;
+            }
+            promise->set_value(res);
+        });
+        return m_pending;
+    }
+
+private:
+    bool poll() {
+        std::atomic<bool>* cancelled = m_cancelled.load(std::memory_order_acquire);
+        return cancelled != nullptr && cancelled->load(std::memory_order_relaxed);
+    }
+
+    thread_pool& m_pool;
+    solver m_solver;
+    solve_future m_pending;
+    std::atomic<std::atomic<bool>*> m_cancelled { nullptr };
+};
+
+}  // namespace ipasir2
+
+#endif  // INTERFACE_IPASIR2_ASYNC_HPP_
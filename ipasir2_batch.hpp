@@ -0,0 +1,149 @@
+/**
+ * \file
+ *
+ * Parallel evaluation of independent assumption sets on top of the C++ wrapper (ipasir2.hpp).
+ *
+ * An ipasir2::batch_solver holds K replicas of one fixed formula, each in its own solver instance.
+ * solve() takes a batch of assumption sets and answers all of them, with one thread per replica.
+ * Results, and the failed assumptions of unsatisfiable queries, are returned in submission order.
+ *
+ * To let the replicas reuse their trails and learned clauses between related queries, the batch is
+ * sorted lexicographically by assumptions, so sets sharing a prefix become neighbours, and is cut
+ * into chunks of consecutive queries. The replicas take chunks from a shared counter, so each chunk
+ * runs on one instance in sorted order while the load stays balanced.
+ *
+ * Example:
+ *
+ *     ipasir2::batch_solver batch(8, [&](ipasir2::solver& s) { s.add_clauses(literals, offsets); });
+ *     std::vector<ipasir2::query_result> results = batch.solve(queries);
+ */
+
+#ifndef INTERFACE_IPASIR2_BATCH_HPP_
+#define INTERFACE_IPASIR2_BATCH_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "ipasir2.hpp"
+
+
+namespace ipasir2 {
+
+struct query_result {
+    result res = result::unknown;
+    std::vector<int32_t> core;  // failed assumptions if res is result::unsat
+};
+
+
+/**
+ * @brief Replicas of a fixed formula answering batches of assumption sets in parallel.
+ */
+class batch_solver {
+public:
+    /**
+     * Creates \p replicas instances and calls \p load on each of them, concurrently, to add the formula.
+     * Errors thrown by \p load are rethrown.
+     */
+    batch_solver(unsigned replicas, std::function<void(solver&)> const& load) {
+        replicas = replicas > 0 ? replicas : 1;
+        m_replicas.resize(replicas);
+        run(replicas, [&](unsigned i) {
+            m_replicas[i].reset(new solver());
+            load(*m_replicas[i]);
+        });
+    }
+
+    size_t replicas() const noexcept {
+        return m_replicas.size();
+    }
+
+    // the instance of replica \p i, e.g. for setting options between batches
+    solver& replica(size_t i) {
+        return *m_replicas[i];
+    }
+
+    /**
+     * Solves the formula under each of the assumption sets in \p queries and returns the results in
+     * the same order. Cores are computed with solver::core() if \p cores is set.
+     * Throws the first ipasir2::error raised by a replica, after all replicas have stopped.
+     */
+    std::vector<query_result> solve(std::vector<std::vector<int32_t>> const& queries, bool cores = true) {
+        std::vector<query_result> results(queries.size());
+        std::vector<size_t> order(queries.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return queries[a] < queries[b]; });
+
+        // several chunks per replica, so that replicas finishing early can take over work
+        size_t chunk = std::max<size_t>(1, queries.size() / (m_replicas.size() * 8));
+        std::atomic<size_t> next { 0 };
+        std::atomic<bool> failed { false };
+        run(m_replicas.size(), [&](unsigned i) {
+            solver& s = *m_replicas[i];
+            for (;;) {
+                size_t first = next.fetch_add(chunk, std::memory_order_relaxed);
+                if (first >= order.size() || failed.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                size_t last = std::min(first + chunk, order.size());
+                for (size_t k = first; k < last; ++k) {
+                    std::vector<int32_t> const& assumptions = queries[order[k]];
+                    query_result& r = results[order[k]];
+                    try {
+                        r.res = s.solve(assumptions);
+                        if (cores && r.res == result::unsat) {
+                            r.core = s.core(assumptions);
+                        }
+                    }
+                    catch (...) {
+                        failed.store(true, std::memory_order_relaxed);
+                        throw;
+                    }
+                }
+            }
+        });
+        return results;
+    }
+
+private:
+    // runs \p task(i) for i in [0, n) on n threads, rethrows the first exception
+    template<typename F>
+    static void run(unsigned n, F const& task) {
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::vector<std::thread> threads;
+        for (unsigned i = 0; i < n; ++i) {
+            threads.emplace_back([&, i]() {
+                try {
+                    task(i);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            });
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::vector<std::unique_ptr<solver>> m_replicas;
+};
+
+}  // namespace ipasir2
+
+#endif  // INTERFACE_IPASIR2_BATCH_HPP_
@@ -0,0 +1,34 @@
+/**
+ * \file
+ *
+ * Optional entry points of IPASIR-2.
+ *
+ * Functions added to the interface after its first version need not be defined by every backend.
+ * This header declares them as weak symbols, so that clients still link against backends which
+ * lack them. The address of a function the backend does not define is nullptr, so a client checks
+ * it before the call and otherwise falls back to the baseline interface:
+ *
+ *     if (ipasir2_add_clauses != nullptr) {
+ *         ret = ipasir2_add_clauses(solver, literals, offsets, count, 0, nullptr);
+ *     }
+ *
+ * Include it in every translation unit calling one of these functions, before the first call.
+ * Weak symbols are a GCC and Clang extension; with other compilers the functions stay required.
+ * Backends loaded at runtime resolve the same functions with dlsym() instead, see src/clients/loader.h.
+ */
+
+#ifndef INTERFACE_IPASIR2_OPTIONAL_H_
+#define INTERFACE_IPASIR2_OPTIONAL_H_
+
+#include "ipasir2.h"
+
+#if defined(__GNUC__)
+#pragma weak ipasir2_add_clauses
+#pragma weak ipasir2_values
+#pragma weak ipasir2_failed_core
+#pragma weak ipasir2_set_option_array
+#pragma weak ipasir2_set_export_batch
+#pragma weak ipasir2_clone
+#endif
+
+#endif
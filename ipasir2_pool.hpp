@@ -0,0 +1,266 @@
+/**
+ * \file
+ *
+ * Pool of pre-initialized solver instances on top of the C++ wrapper (ipasir2.hpp).
+ *
+ * For short queries, ipasir2_init() and ipasir2_release() can dominate the latency. An
+ * ipasir2::solver_pool keeps a number of instances which are initialized and configured in
+ * advance by a background thread: each instance is created with ipasir2_init() and the options of
+ * the pool's ipasir2::config are applied while it is still in the CONFIG state. acquire() hands out
+ * one of these instances and falls back to creating one on the spot if the pool is empty.
+ *
+ * IPASIR-2 has no way of resetting an instance to the CONFIG state, so a returned instance is not
+ * handed out again. Instead, it is released by the background thread, which also creates its
+ * replacement, so neither the release nor the initialization is on the caller's path.
+ *
+ * Example:
+ *
+ *     ipasir2::solver_pool pool(ipasir2::config().set("ipasir.limits.conflicts", 1000), 8);
+ *     for (query const& q : queries) {
+ *         ipasir2::pooled_solver s = pool.acquire();
+ *         s->add_clauses(q.literals, q.offsets);
+ *         q.answer(s->solve(q.assumptions));
+ *     }   // s is returned to the pool here
+ */
+
+#ifndef INTERFACE_IPASIR2_POOL_HPP_
+#define INTERFACE_IPASIR2_POOL_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ipasir2.hpp"
+
+
+namespace ipasir2 {
+
+/**
+ * @brief Snapshot of option settings, applied to a solver instance in the CONFIG state.
+ */
+class config {
+public:
+    struct setting {
+        std::string name;
+        int64_t value;
+        int64_t index;
+    };
+
+    config& set(std::string name, int64_t value, int64_t index = 0) {
+        m_settings.push_back({ std::move(name), value, index });
+        return *this;
+    }
+
+    // applies the settings in the order they were set, throws ipasir2::error on the first failing one
+    void apply(solver& s) const {
+        for (setting const& option : m_settings) {
+            s.set_option(option.name.c_str(), option.value, option.index);
+        }
+    }
+
+    std::vector<setting> const& settings() const noexcept {
+        return m_settings;
+    }
+
+private:
+    std::vector<setting> m_settings;
+};
+
+
+class solver_pool;
+
+/**
+ * @brief Solver instance acquired from a solver_pool, which is returned to the pool on destruction.
+ */
+class pooled_solver {
+public:
+    pooled_solver(pooled_solver&& other) noexcept
+        : m_solver(std::move(other.m_solver)), m_pool(std::exchange(other.m_pool, nullptr)) {}
+
+    pooled_solver& operator=(pooled_solver&& other) noexcept;
+
+    pooled_solver(pooled_solver const&) = delete;
+    pooled_solver& operator=(pooled_solver const&) = delete;
+
+    ~pooled_solver();
+
+    solver& operator*() noexcept { return m_solver; }
+    solver* operator->() noexcept { return &m_solver; }
+
+private:
+    friend class solver_pool;
+
+    pooled_solver(solver&& s, solver_pool* pool) noexcept : m_solver(std::move(s)), m_pool(pool) {}
+
+    solver m_solver;
+    solver_pool* m_pool;
+};
+
+
+/**
+ * @brief Pre-initialized and configured solver instances of the linked backend.
+ * @details The constructor configures the first instance synchronously, so that errors in the
+ * configuration are thrown there. The pool must outlive the instances acquired from it.
+ */
+class solver_pool {
+public:
+    struct stats {
+        uint64_t pooled = 0;  // acquire() calls served from the pool
+        uint64_t cold = 0;    // acquire() calls which had to initialize an instance
+    };
+
+    explicit solver_pool(config snapshot = {}, size_t capacity = 4)
+        : m_config(std::move(snapshot)), m_capacity(capacity > 0 ? capacity : 1), m_batch((m_capacity + 1) / 2) {
+        m_ready.push_back(create());
+        m_worker = std::thread([this]() { work(); });
+    }
+
+    ~solver_pool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopped = true;
+        }
+        m_wakeup.notify_all();
+        m_worker.join();
+    }
+
+    solver_pool(solver_pool const&) = delete;
+    solver_pool& operator=(solver_pool const&) = delete;
+
+    /**
+     * Returns a configured instance in the CONFIG state.
+     * Rethrows the error of the background thread if configuring an instance failed there.
+     */
+    pooled_solver acquire() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_error) {
+                std::rethrow_exception(m_error);
+            }
+            if (!m_ready.empty()) {
+                solver s = std::move(m_ready.front());
+                m_ready.pop_front();
+                ++m_stats.pooled;
+                if (m_ready.size() + m_batch == m_capacity) {
+                    m_wakeup.notify_one();
+                }
+                return pooled_solver(std::move(s), this);
+            }
+            ++m_stats.cold;
+        }
+        m_wakeup.notify_one();
+        return pooled_solver(create(), this);
+    }
+
+    // number of configured instances currently waiting in the pool
+    size_t available() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_ready.size();
+    }
+
+    stats statistics() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+private:
+    friend class pooled_solver;
+
+    solver create() const {
+        solver s;
+        m_config.apply(s);
+        return s;
+    }
+
+    void recycle(solver&& s) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_retired.push_back(std::move(s));
+        if (m_retired.size() == m_batch) {
+            m_wakeup.notify_one();
+        }
+    }
+
+    /**
+     * Releases returned instances and refills the pool up to its capacity. To keep wake-ups off the
+     * callers' path, the thread is woken only once per batch of half the capacity, and then works
+     * until the pool is full and all returned instances are released.
+     */
+    void work() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        bool busy = true;
+        for (;;) {
+            if (!busy) {
+                m_wakeup.wait(lock, [this]() {
+                    return m_stopped || m_retired.size() >= m_batch || (!m_error && m_ready.size() + m_batch <= m_capacity);
+                });
+            }
+            if (!m_retired.empty()) {
+                std::vector<solver> retired;
+                retired.swap(m_retired);
+                lock.unlock();
+                retired.clear();
+                lock.lock();
+                busy = true;
+                continue;
+            }
+            if (m_stopped) {
+                return;
+            }
+            busy = !m_error && m_ready.size() < m_capacity;
+            if (!busy) {
+                continue;
+            }
+            lock.unlock();
+            try {
+                solver s = create();
+                lock.lock();
+                m_ready.push_back(std::move(s));
+            }
+            catch (...) {
+                lock.lock();
+                m_error = std::current_exception();
+            }
+        }
+    }
+
+    config const m_config;
+    size_t const m_capacity;
+    size_t const m_batch;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    std::deque<solver> m_ready;
+    std::vector<solver> m_retired;
+    std::exception_ptr m_error;
+    stats m_stats;
+    bool m_stopped = false;
+    std::thread m_worker;
+};
+
+
+inline pooled_solver& pooled_solver::operator=(pooled_solver&& other) noexcept {
+    if (this != &other) {
+        if (m_pool != nullptr) {
+            m_pool->recycle(std::move(m_solver));
+        }
+        m_solver = std::move(other.m_solver);
+        m_pool = std::exchange(other.m_pool, nullptr);
+    }
+    return *this;
+}
+
+inline pooled_solver::~pooled_solver() {
+    if (m_pool != nullptr) {
+        m_pool->recycle(std::move(m_solver));
+    }
+}
+
+}  // namespace ipasir2
+
+#endif  // INTERFACE_IPASIR2_POOL_HPP_
@@ -0,0 +1,409 @@
+/**
+ * MIT License
+ *
+ * Computes the backbone of a DIMACS CNF formula, the literals which are true in all of its models.
+ *
+ * Usage: backbone [-t threads] [-k initial chunk size] [-r replicate instead of clone] <file.cnf>
+ *
+ * Literals fixed at decision level zero are backbone literals. They are collected with
+ * ipasir2_set_fixed(), first in a solve call with ipasir.limits.decisions = 0, which only propagates,
+ * and then during all following calls. The first model gives the candidates, one literal per variable.
+ * Each further model drops the candidates it falsifies.
+ *
+ * The remaining candidates are probed in chunks: the solver is asked for a model falsifying at least
+ * one literal of the chunk, with a clause of the negated literals guarded by an activation literal
+ * (a chunk of one literal is simply assumed negated). If there is none, all literals of the chunk are
+ * backbone literals and are added as units. Otherwise the model filters the candidates. The chunk
+ * size doubles after each refutation and halves after each model, so it grows while most candidates
+ * turn out to be backbone literals and shrinks to single probes otherwise. To make each model falsify
+ * as many candidates as possible, the initial phases are set against the first model with
+ * ipasir.variables.phase.initial, where supported.
+ *
+ * With several threads, the workers share the candidates, the models' verdicts and the backbone
+ * literals found. The additional instances are cloned from the first one with ipasir2_clone(),
+ * keeping its learned clauses, or, if the backend does not support this, replicated from the formula.
+ *
+ * Prints "s SATISFIABLE" followed by the backbone in "b" lines, or "s UNSATISFIABLE".
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ipasir2.h"
+#include "ipasir2_util.h"
+#include "dimacs.h"
+
+
+struct formula {
+    std::vector<int32_t> literals;
+    std::vector<int32_t> offsets { 0 };
+    int32_t max_var = 0;
+};
+
+/**
+ * Candidate literals and verdicts, shared between the workers
+ */
+class backbone_state {
+public:
+    enum verdict : uint8_t { UNDECIDED = 0, BACKBONE, FLIPPED };
+
+    // the candidates are the literals of the first model, variables without a value are no backbone
+    backbone_state(std::vector<int8_t> const& model) : m_phase(model), m_verdict(model.size() + 1) {
+        for (int32_t var = 1; var <= static_cast<int32_t>(model.size()); ++var) {
+            if (model[var - 1] == 0) {
+                m_verdict[var].store(FLIPPED, std::memory_order_relaxed);
+            }
+            else {
+                m_candidates.push_back(var);
+            }
+        }
+    }
+
+    bool undecided(int32_t lit) const {
+        return m_verdict[std::abs(lit)].load(std::memory_order_relaxed) == UNDECIDED;
+    }
+
+    // appends undecided candidates to \p chunk until it has \p size literals, returns false if there are none left
+    bool take(std::vector<int32_t>& chunk, size_t size) {
+        while (chunk.size() < size) {
+            size_t i = m_next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= m_candidates.size()) {
+                break;
+            }
+            int32_t var = m_candidates[i];
+            if (undecided(var)) {
+                chunk.push_back(m_phase[var - 1] > 0 ? var : -var);
+            }
+        }
+        return !chunk.empty();
+    }
+
+    // drops the candidates falsified by \p model, returns the number of candidates dropped
+    uint64_t filter(std::vector<int8_t> const& model) {
+        uint64_t dropped = 0;
+        for (int32_t var : m_candidates) {
+            if (model[var - 1] != m_phase[var - 1] && undecided(var)) {
+                uint8_t expected = UNDECIDED;
+                dropped += m_verdict[var].compare_exchange_strong(expected, FLIPPED, std::memory_order_relaxed);
+            }
+        }
+        return dropped;
+    }
+
+    // records the backbone literal \p lit, literals of variables beyond the formula are ignored
+    void fix(int32_t lit) {
+        int32_t var = std::abs(lit);
+        if (var > static_cast<int32_t>(m_phase.size())) {
+            return;
+        }
+        uint8_t expected = UNDECIDED;
+        if (m_verdict[var].compare_exchange_strong(expected, BACKBONE, std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_backbone.push_back(lit);
+        }
+    }
+
+    // adds the backbone literals from index \p next on as units to the solver, returns the new index
+    size_t import(void* solver, size_t next) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (; next < m_backbone.size(); ++next) {
+            ipasir2_add(solver, &m_backbone[next], 1, 0, nullptr);
+        }
+        return next;
+    }
+
+    std::vector<int32_t> backbone() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<int32_t> result = m_backbone;
+        std::sort(result.begin(), result.end(), [](int32_t a, int32_t b) { return std::abs(a) < std::abs(b); });
+        return result;
+    }
+
+    size_t candidates() const {
+        return m_candidates.size();
+    }
+
+    // polarity of variable \p var in the first model
+    int8_t phase(int32_t var) const {
+        return m_phase[var - 1];
+    }
+
+private:
+    std::vector<int8_t> m_phase;
+    std::vector<std::atomic<uint8_t>> m_verdict;
+    std::vector<int32_t> m_candidates;
+    std::atomic<size_t> m_next { 0 };
+
+    std::mutex m_mutex;
+    std::vector<int32_t> m_backbone;
+};
+
+struct worker {
+    int32_t id;
+    void* solver = nullptr;
+    ipasir2_errorcode err = IPASIR2_E_OK;
+    int32_t next_var = 0;            // last activation variable
+    std::vector<int32_t> fixed;      // level zero literals reported since the last solve call
+    uint64_t sat = 0;
+    uint64_t unsat = 0;
+    uint64_t dropped = 0;
+    size_t imported = 0;
+};
+
+void collect_fixed(void* data, int32_t lit) {
+    static_cast<worker*>(data)->fixed.push_back(lit);
+}
+
+void check(ipasir2_errorcode err, char const* function) {
+    if (err) {
+        throw std::runtime_error(std::string(function) + "() returned " + ipasir2_errorcode_to_string(err));
+    }
+}
+
+// Probes chunks of candidates on the worker's instance until all candidates are decided
+ipasir2_errorcode probe(worker& w, backbone_state& state, int32_t max_var, size_t chunk_size) {
+    size_t const max_chunk_size = 4096;
+    std::vector<int32_t> chunk;
+    std::vector<int32_t> clause;
+    std::vector<int8_t> model(max_var);
+
+    // models falsifying many candidates at once let the filter do most of the work
+    ipasir2_option_index options(w.solver);
+    if (ipasir2_option const* initial = options.find(IPASIR2_O_VARIABLES_PHASE_INITIAL)) {
+        std::vector<int64_t> phases(max_var);
+        for (int32_t var = 1; var <= max_var; ++var) {
+            phases[var - 1] = -state.phase(var);
+        }
+        ipasir2_set_option_values(w.solver, initial, phases.data(), nullptr, 1, max_var);
+    }
+
+    for (;;) {
+        w.imported = state.import(w.solver, w.imported);
+        chunk.erase(std::remove_if(chunk.begin(), chunk.end(), [&](int32_t lit) { return !state.undecided(lit); }), chunk.end());
+        if (!state.take(chunk, chunk_size)) {
+            return IPASIR2_E_OK;
+        }
+
+        int32_t assumption;
+        if (chunk.size() == 1) {
+            assumption = -chunk[0];
+        }
+        else {
+            assumption = ++w.next_var;
+            clause.assign(1, -assumption);
+            for (int32_t lit : chunk) {
+                clause.push_back(-lit);
+            }
+            ipasir2_errorcode err = ipasir2_add(w.solver, clause.data(), clause.size(), 0, nullptr);
+            if (err) return err;
+        }
+
+        int result = 0;
+        ipasir2_errorcode err = ipasir2_solve(w.solver, &result, &assumption, 1);
+        if (err) return err;
+        for (int32_t lit : w.fixed) {
+            state.fix(lit);
+        }
+        w.fixed.clear();
+        if (result == RESULT_SAT) {
+            ++w.sat;
+            err = ipasir2_model(w.solver, 1, max_var, model.data());
+            if (err) return err;
+            w.dropped += state.filter(model);
+            chunk_size = std::max<size_t>(1, chunk_size / 2);
+        }
+        else if (result == RESULT_UNSAT) {
+            ++w.unsat;
+            for (int32_t lit : chunk) {
+                state.fix(lit);
+            }
+            chunk.clear();
+            chunk_size = std::min(max_chunk_size, chunk_size * 2);
+        }
+        else {
+            return IPASIR2_E_UNKNOWN;
+        }
+        if (assumption > max_var) {
+            // retires the chunk clause
+            int32_t unit = -assumption;
+            err = ipasir2_add(w.solver, &unit, 1, 0, nullptr);
+            if (err) return err;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    int32_t threads = 1;
+    size_t chunk_size = 8;
+    bool replicate = false;
+    char const* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-t" && i + 1 < argc) {
+            threads = std::stoi(argv[++i]);
+        }
+        else if (arg == "-k" && i + 1 < argc) {
+            chunk_size = std::stoul(argv[++i]);
+        }
+        else if (arg == "-r") {
+            replicate = true;
+        }
+        else {
+            path = argv[i];
+        }
+    }
+    if (path == nullptr) {
+        std::cerr << "Usage: " << argv[0] << " [-t threads] [-k initial chunk size] [-r replicate instead of clone] <file.cnf>" << std::endl;
+        return 1;
+    }
+    threads = std::max(threads, 1);
+    chunk_size = std::max<size_t>(chunk_size, 1);
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "c solver: " << signature << ", " << threads << " workers" << std::endl;
+
+    formula f;
+    try {
+        dimacs_reader reader(path);
+        while (reader.next() == dimacs_reader::CLAUSES) {
+            f.literals.insert(f.literals.end(), reader.literals(), reader.literals() + reader.offsets()[reader.count()]);
+            for (int32_t i = 1; i <= reader.count(); ++i) {
+                f.offsets.push_back(f.offsets.back() + reader.offsets()[i] - reader.offsets()[i - 1]);
+            }
+        }
+        f.max_var = reader.max_variable();
+    }
+    catch (std::runtime_error const& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<worker> workers(threads);
+    for (int32_t id = 0; id < threads; ++id) {
+        workers[id].id = id;
+        workers[id].next_var = f.max_var;
+    }
+    std::unique_ptr<backbone_state> state;
+    int result = 0;
+    size_t prefixed = 0;
+    try {
+        worker& first = workers[0];
+        check(ipasir2_init(&first.solver), "ipasir2_init");
+        check(ipasir2_set_fixed(first.solver, &first, collect_fixed), "ipasir2_set_fixed");
+        check(ipasir2_add_formula(first.solver, f.literals.data(), f.offsets.data(), f.offsets.size() - 1), "ipasir2_add_clauses");
+
+        // propagation only, if the backend supports a decision limit
+        ipasir2_option_index options(first.solver);
+        ipasir2_option const* decisions = options.find(IPASIR2_O_LIMITS_DECISIONS);
+        if (decisions != nullptr && ipasir2_set_option(first.solver, decisions, 0, 0) == IPASIR2_E_OK) {
+            check(ipasir2_solve(first.solver, &result, nullptr, 0), "ipasir2_solve");
+            check(ipasir2_set_option(first.solver, decisions, -1, 0), "ipasir2_set_option");
+            prefixed = first.fixed.size();
+        }
+        if (result != RESULT_UNSAT) {
+            check(ipasir2_solve(first.solver, &result, nullptr, 0), "ipasir2_solve");
+        }
+        if (result == RESULT_SAT) {
+            std::vector<int8_t> model(f.max_var);
+            check(ipasir2_model(first.solver, 1, f.max_var, model.data()), "ipasir2_values");
+            state.reset(new backbone_state(model));
+            for (int32_t lit : first.fixed) {
+                state->fix(lit);
+            }
+        }
+    }
+    catch (std::runtime_error const& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    if (result == RESULT_SAT) {
+        std::cout << "c " << state->candidates() << " candidates, " << prefixed << " literals fixed by propagation" << std::endl;
+
+        // clones share the first instance's learned clauses, so they are made before any thread starts
+        ipasir2_errorcode cloning = replicate || ipasir2_clone == nullptr ? IPASIR2_E_UNSUPPORTED : IPASIR2_E_OK;
+        for (int32_t id = 1; id < threads && !cloning; ++id) {
+            cloning = ipasir2_clone(workers[0].solver, &workers[id].solver);
+        }
+        std::cout << "c " << (threads == 1 ? "single instance" : cloning ? "replicated instances" : "cloned instances") << std::endl;
+
+        std::vector<std::thread> pool;
+        for (int32_t id = 0; id < threads; ++id) {
+            pool.emplace_back([&, id]() {
+                worker& w = workers[id];
+                if (w.solver == nullptr) {
+                    w.err = ipasir2_init(&w.solver);
+                    if (w.err) return;
+                    w.err = ipasir2_add_formula(w.solver, f.literals.data(), f.offsets.data(), f.offsets.size() - 1);
+                    if (w.err) return;
+                }
+                w.err = ipasir2_set_fixed(w.solver, &w, collect_fixed);
+                if (w.err) return;
+                w.err = probe(w, *state, f.max_var, chunk_size);
+            });
+        }
+        for (std::thread& t : pool) {
+            t.join();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    bool complete = true;
+    for (worker const& w : workers) {
+        if (result != RESULT_SAT) {
+            break;
+        }
+        std::cout << "c worker " << w.id << ": " << w.sat << " models, " << w.unsat << " refuted chunks, ";
+        std::cout << w.dropped << " candidates dropped, " << w.imported << " units imported";
+        if (w.err) {
+            std::cout << ", error " << ipasir2_errorcode_to_string(w.err);
+            complete = false;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "c total time: " << seconds << " s" << std::endl;
+
+    if (result == RESULT_SAT && complete) {
+        puts("s SATISFIABLE");
+        std::vector<int32_t> backbone = state->backbone();
+        std::cout << "c backbone size: " << backbone.size() << std::endl;
+        std::string line = "b";
+        for (int32_t lit : backbone) {
+            line += ' ';
+            line += std::to_string(lit);
+            if (line.size() > 76) {
+                puts(line.c_str());
+                line = "b";
+            }
+        }
+        line += " 0";
+        puts(line.c_str());
+    }
+    else if (result == RESULT_UNSAT) {
+        puts("s UNSATISFIABLE");
+    }
+    else {
+        puts("s UNKNOWN");
+        result = 0;
+    }
+
+    for (worker& w : workers) {
+        if (w.solver != nullptr) {
+            ipasir2_release(w.solver);
+        }
+    }
+    return result;
+}
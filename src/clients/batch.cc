@@ -0,0 +1,117 @@
+/**
+ * MIT License
+ *
+ * Answers the queries of an iCNF file in parallel with a batch_solver (ipasir2_batch.hpp).
+ *
+ * Usage: batch [-t replicas] [-n no cores] <file.icnf>
+ *
+ * Unlike solve, which answers the "a <lits> 0" lines incrementally in file order, this treats
+ * them as independent queries against one fixed formula, so all clauses must precede the first
+ * query. For each query, in file order, "s SATISFIABLE" or "s UNSATISFIABLE" is printed, the
+ * latter followed by the failed assumptions in an "f" line.
+ *
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ipasir2.h"
+#include "ipasir2.hpp"
+#include "ipasir2_batch.hpp"
+#include "dimacs.h"
+
+
+int main(int argc, char** argv) {
+    unsigned replicas = std::thread::hardware_concurrency();
+    bool cores = true;
+    char const* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-t" && i + 1 < argc) {
+            replicas = std::stoi(argv[++i]);
+        }
+        else if (arg == "-n") {
+            cores = false;
+        }
+        else {
+            path = argv[i];
+        }
+    }
+    if (path == nullptr) {
+        std::cerr << "Usage: " << argv[0] << " [-t replicas] [-n no cores] <file.icnf>" << std::endl;
+        return 1;
+    }
+
+    std::cout << "c solver: " << ipasir2::solver::signature() << std::endl;
+
+    std::vector<int32_t> literals;
+    std::vector<int32_t> offsets { 0 };
+    std::vector<std::vector<int32_t>> queries;
+    try {
+        dimacs_reader reader(path);
+        for (dimacs_reader::event ev = reader.next(); ev != dimacs_reader::END; ev = reader.next()) {
+            if (ev == dimacs_reader::ASSUMPTIONS) {
+                queries.push_back(reader.assumptions());
+                continue;
+            }
+            if (!queries.empty()) {
+                throw std::runtime_error("clauses after the first query are not supported, the formula must be fixed");
+            }
+            literals.insert(literals.end(), reader.literals(), reader.literals() + reader.offsets()[reader.count()]);
+            for (int32_t i = 1; i <= reader.count(); ++i) {
+                offsets.push_back(offsets.back() + reader.offsets()[i] - reader.offsets()[i - 1]);
+            }
+        }
+    }
+    catch (std::runtime_error const& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        ipasir2::batch_solver batch(replicas, [&](ipasir2::solver& s) { s.add_clauses(literals, offsets); });
+        double load_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "c " << batch.replicas() << " replicas loaded in " << load_time << " s" << std::endl;
+
+        start = std::chrono::steady_clock::now();
+        std::vector<ipasir2::query_result> results = batch.solve(queries, cores);
+        double solve_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (ipasir2::query_result const& r : results) {
+            if (r.res == ipasir2::result::sat) {
+                puts("s SATISFIABLE");
+            }
+            else if (r.res == ipasir2::result::unsat) {
+                puts("s UNSATISFIABLE");
+                if (cores) {
+                    std::string line = "f";
+                    for (int32_t lit : r.core) {
+                        line += ' ';
+                        line += std::to_string(lit);
+                    }
+                    line += " 0";
+                    puts(line.c_str());
+                }
+            }
+            else {
+                puts("s UNKNOWN");
+            }
+        }
+        std::cout << "c " << queries.size() << " queries in " << solve_time << " s";
+        if (!queries.empty()) {
+            std::cout << ", " << 1e6 * solve_time / queries.size() << " us per query";
+        }
+        std::cout << std::endl;
+    }
+    catch (ipasir2::error const& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
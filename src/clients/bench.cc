@@ -0,0 +1,266 @@
+/**
+ * MIT License
+ *
+ * Measures the per-call overhead of the IPASIR-2 functions on tiny incremental queries,
+ * the cost of setting and looking up options, and the dispatch cost of the terminate callback.
+ *
+ * Topics with their own benchmarks: bench_add (clause ingestion), bench_failed (failed assumptions),
+ * bench_share (clause sharing), bench_wrapper (C++ callbacks), bench_async, bench_pool, bench_batch,
+ * bench_clone, bench_trail, bench_proof, bench_dl (loaded backends) and bench_trace (tracing shim).
+ *
+ * Usage: bench [calls] [pigeonhole holes] [proprietary options]
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ipasir2.h"
+#include "ipasir2_util.h"
+#include "ipasir2_bench.h"
+
+
+void bench_add(int calls) {
+    void* solver;
+    ipasir2_init(&solver);
+    std::mt19937 rng(1);
+    latency_sampler sampler("ipasir2_add()");
+    for (int i = 0; i < calls; ++i) {
+        int32_t clause[2] = { static_cast<int32_t>(1 + rng() % 1000), -static_cast<int32_t>(1 + rng() % 1000) };
+        sampler.measure([&]() { return ipasir2_add(solver, clause, 2, 0, nullptr); });
+    }
+    sampler.report();
+    ipasir2_release(solver);
+}
+
+void bench_solve(int calls) {
+    void* solver;
+    ipasir2_init(&solver);
+    ipasir2_add_formula(solver, {{ 1, 2 }, { -1, 3 }, { -2, -3 }});
+    latency_sampler plain("ipasir2_solve()");
+    latency_sampler assuming("ipasir2_solve(1 assumption)");
+    int result;
+    int32_t assumption = -1;
+    for (int i = 0; i < calls; ++i) {
+        plain.measure([&]() { return ipasir2_solve(solver, &result, nullptr, 0); });
+        assuming.measure([&]() { return ipasir2_solve(solver, &result, &assumption, 1); });
+    }
+    plain.report();
+    assuming.report();
+    ipasir2_release(solver);
+}
+
+void bench_value(int calls) {
+    void* solver;
+    ipasir2_init(&solver);
+    int32_t const vars = 1000;
+    for (int32_t v = 1; v < vars; ++v) {
+        int32_t clause[2] = { -v, v + 1 };
+        ipasir2_add(solver, clause, 2, 0, nullptr);
+    }
+    int result;
+    ipasir2_solve(solver, &result, nullptr, 0);
+    std::mt19937 rng(1);
+    latency_sampler sampler("ipasir2_value()");
+    for (int i = 0; i < calls; ++i) {
+        int32_t lit = 1 + rng() % vars;
+        int32_t value;
+        sampler.measure([&]() { return ipasir2_value(solver, lit, &value); });
+    }
+    sampler.report();
+    ipasir2_release(solver);
+}
+
+void bench_failed(int calls) {
+    void* solver;
+    ipasir2_init(&solver);
+    ipasir2_add_clause(solver, { -1, -2 });
+    std::vector<int32_t> assumptions;
+    for (int32_t v = 1; v <= 100; ++v) {
+        assumptions.push_back(v);
+    }
+    int result;
+    ipasir2_solve(solver, &result, assumptions.data(), assumptions.size());
+    std::mt19937 rng(1);
+    latency_sampler sampler("ipasir2_failed()");
+    for (int i = 0; i < calls; ++i) {
+        int32_t lit = assumptions[rng() % assumptions.size()];
+        int failed;
+        sampler.measure([&]() { return ipasir2_failed(solver, lit, &failed); });
+    }
+    sampler.report();
+    ipasir2_release(solver);
+}
+
+void bench_set_option(int calls) {
+    void* solver;
+    ipasir2_init(&solver);
+    ipasir2_add_clause(solver, { 1 });
+    ipasir2_option const* handle;
+    if (ipasir2_get_option_handle(solver, "ipasir.limits.conflicts", &handle) != IPASIR2_E_OK) {
+        printf("%-32s unavailable\n", "ipasir2_set_option()");
+        ipasir2_release(solver);
+        return;
+    }
+    latency_sampler sampler("ipasir2_set_option()");
+    for (int i = 0; i < calls; ++i) {
+        sampler.measure([&]() { return ipasir2_set_option(solver, handle, -1, 0); });
+    }
+    sampler.report();
+    ipasir2_release(solver);
+}
+
+void bench_set_option_array(int32_t vars) {
+    void* solver;
+    ipasir2_init(&solver);
+    ipasir2_option const* handle;
+    if (ipasir2_set_option_array == nullptr || ipasir2_get_option_handle(solver, "ipasir.variables.phase.initial", &handle) != IPASIR2_E_OK) {
+        printf("%-32s unavailable\n", "ipasir2_set_option_array()");
+        ipasir2_release(solver);
+        return;
+    }
+    std::vector<int64_t> phases(vars);
+    for (int32_t i = 0; i < vars; ++i) {
+        phases[i] = i % 2 ? 1 : -1;
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < vars; ++i) {
+        ipasir2_set_option(solver, handle, phases[i], i + 1);
+    }
+    double single = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    printf("%-32s %10d %12s %12s %12.1f\n", "phases via set_option()", vars, "-", "-", single / vars);
+
+    start = std::chrono::steady_clock::now();
+    ipasir2_errorcode err = ipasir2_set_option_array(solver, handle, phases.data(), nullptr, 1, vars);
+    double bulk = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    if (err) {
+        printf("%-32s %s\n", "phases via set_option_array()", ipasir2_errorcode_to_string(err).c_str());
+    } else {
+        printf("%-32s %10d %12s %12s %12.1f\n", "phases via set_option_array()", vars, "-", "-", bulk / vars);
+    }
+    ipasir2_release(solver);
+}
+
+// Linear search as in ipasir2_get_option_handle(), but over a given option array
+ipasir2_option const* linear_lookup(ipasir2_option const* options, int count, char const* name) {
+    for (int i = 0; i < count; ++i) {
+        if (strcmp(options[i].name, name) == 0) {
+            return &options[i];
+        }
+    }
+    return nullptr;
+}
+
+void bench_option_lookup(int calls, int proprietary) {
+    char const* name = ipasir2_standard_option_names[IPASIR2_O_VARIABLES_PHASE_INITIAL];
+
+    void* solver;
+    ipasir2_init(&solver);
+    ipasir2_option const* handle;
+    if (ipasir2_get_option_handle(solver, name, &handle) == IPASIR2_E_OK) {
+        latency_sampler linear("get_option_handle(solver)");
+        latency_sampler hashed("option_index(solver)");
+        ipasir2_option_index index(solver);
+        for (int i = 0; i < calls; ++i) {
+            linear.measure([&]() { return ipasir2_get_option_handle(solver, name, &handle); });
+            hashed.measure([&]() { return index.get(name, &handle); });
+        }
+        linear.report();
+        hashed.report();
+    }
+    ipasir2_release(solver);
+
+    // Synthetic option list with many proprietary options in front of the standard options
+    std::vector<std::string> names;
+    for (int i = 0; i < proprietary; ++i) {
+        names.push_back("vendor.heuristics.parameter" + std::to_string(i));
+    }
+    for (char const* standard : ipasir2_standard_option_names) {
+        names.push_back(standard);
+    }
+    std::vector<ipasir2_option> options;
+    for (std::string const& n : names) {
+        options.push_back({ n.c_str(), 0, 1, IPASIR2_S_SOLVING, 0, 0, nullptr });
+    }
+
+    std::string suffix = "(" + std::to_string(options.size()) + " options)";
+    latency_sampler linear("linear " + suffix);
+    latency_sampler hashed("option_index " + suffix);
+    latency_sampler standard("standard table " + suffix);
+    ipasir2_option_index index(options.data(), options.size());
+    for (int i = 0; i < calls; ++i) {
+        linear.measure([&]() { return linear_lookup(options.data(), options.size(), name); });
+        hashed.measure([&]() { return index.find(name); });
+        standard.measure([&]() { return index.find(IPASIR2_O_VARIABLES_PHASE_INITIAL); });
+    }
+    linear.report();
+    hashed.report();
+    standard.report();
+}
+
+// Callback dispatch cannot be timed from the outside call by call. Instead, a solve call with a
+// no-op terminate callback is compared to one without, and the difference is divided by the number
+// of callback invocations.
+void bench_callback(int32_t holes, int rounds) {
+    csr_formula f = pigeonhole(holes);
+    double best_plain = -1;
+    double best_callback = -1;
+    uint64_t invocations = 0;
+    for (int r = 0; r < rounds; ++r) {
+        for (bool with_callback : { false, true }) {
+            void* solver;
+            ipasir2_init(&solver);
+            ipasir2_add_formula(solver, f.literals.data(), f.offsets.data(), f.size());
+            uint64_t count = 0;
+            if (with_callback) {
+                ipasir2_set_terminate(solver, &count, [](void* data) {
+                    ++*static_cast<uint64_t*>(data);
+                    return 0;
+                });
+            }
+            int result;
+            auto start = std::chrono::steady_clock::now();
+            ipasir2_solve(solver, &result, nullptr, 0);
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            ipasir2_release(solver);
+            double& best = with_callback ? best_callback : best_plain;
+            if (best < 0 || ns < best) {
+                best = ns;
+            }
+            if (with_callback) {
+                invocations = count;
+            }
+        }
+    }
+    if (invocations == 0) {
+        printf("%-32s no invocations\n", "terminate callback");
+        return;
+    }
+    printf("%-32s %10llu %12s %12s %12.1f\n", "terminate callback", static_cast<unsigned long long>(invocations), "-", "-",
+        (best_callback - best_plain) / invocations);
+}
+
+int main(int argc, char** argv) {
+    int calls = argc > 1 ? std::stoi(argv[1]) : 100000;
+    int32_t holes = argc > 2 ? std::stoi(argv[2]) : 8;
+    int proprietary = argc > 3 ? std::stoi(argv[3]) : 1000;
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "Solver: " << signature << std::endl;
+
+    latency_sampler::report_header();
+    bench_add(calls);
+    bench_solve(calls / 10);
+    bench_value(calls);
+    bench_failed(calls);
+    bench_set_option(calls);
+    bench_set_option_array(calls * 10);
+    bench_option_lookup(calls / 10, proprietary);
+    bench_callback(holes, 3);
+}
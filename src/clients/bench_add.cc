@@ -0,0 +1,75 @@
+/**
+ * MIT License
+ *
+ * Compares per-clause ingestion via ipasir2_add() with bulk ingestion via ipasir2_add_clauses().
+ *
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ipasir2.h"
+#include "ipasir2_util.h"
+#include "ipasir2_bench.h"
+
+
+template<typename F>
+double time_ingestion(F ingest, int rounds) {
+    double best = 0;
+    for (int r = 0; r < rounds; ++r) {
+        void* solver;
+        ipasir2_init(&solver);
+        auto start = std::chrono::steady_clock::now();
+        ipasir2_errorcode err = ingest(solver);
+        auto end = std::chrono::steady_clock::now();
+        ipasir2_release(solver);
+        if (err) {
+            std::cout << "ingestion failed: " << err << std::endl;
+            return -1;
+        }
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        if (r == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    int32_t n_clauses = argc > 1 ? std::stoi(argv[1]) : 1000000;
+    int32_t n_vars = argc > 2 ? std::stoi(argv[2]) : n_clauses / 4;
+    int rounds = argc > 3 ? std::stoi(argv[3]) : 5;
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "Solver: " << signature << std::endl;
+    std::cout << "Formula: " << n_clauses << " random 3-clauses over " << n_vars << " variables, best of " << rounds << " rounds" << std::endl;
+
+    csr_formula f = random_ksat(n_clauses, n_vars, 3, 42);
+
+    double per_clause = time_ingestion([&](void* solver) {
+        for (int32_t i = 0; i < f.size(); ++i) {
+            ipasir2_errorcode err = ipasir2_add(solver, f.literals.data() + f.offsets[i], f.offsets[i+1] - f.offsets[i], 0, nullptr);
+            if (err) return err;
+        }
+        return IPASIR2_E_OK;
+    }, rounds);
+
+    double bulk = time_ingestion([&](void* solver) {
+        if (ipasir2_add_clauses == nullptr) {
+            return IPASIR2_E_UNSUPPORTED;
+        }
+        return ipasir2_add_clauses(solver, f.literals.data(), f.offsets.data(), f.size(), 0, nullptr);
+    }, rounds);
+
+    std::cout << "ipasir2_add():         " << per_clause / f.size() << " ns/clause" << std::endl;
+    if (bulk < 0) {
+        std::cout << "ipasir2_add_clauses(): unavailable" << std::endl;
+        return 0;
+    }
+    std::cout << "ipasir2_add_clauses(): " << bulk / f.size() << " ns/clause" << std::endl;
+    std::cout << "Speedup: " << per_clause / bulk << "x" << std::endl;
+}
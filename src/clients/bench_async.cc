@@ -0,0 +1,65 @@
+/**
+ * MIT License
+ *
+ * Measures how quickly a running asynchronous solve call (ipasir2_async.hpp) stops when cancelled.
+ *
+ * Usage: bench_async [pigeonhole holes] [rounds]
+ *
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "ipasir2.h"
+#include "ipasir2.hpp"
+#include "ipasir2_async.hpp"
+#include "ipasir2_bench.h"
+
+
+// Latency from solve_future::cancel() until the future of a running asynchronous solve call is
+// ready, which is bounded by the polling interval of the terminate callback in the backend.
+void bench_cancel(int32_t holes, int rounds) {
+    csr_formula f = pigeonhole(holes);
+    ipasir2::thread_pool pool(1);
+    latency_sampler sampler("async solve cancel");
+    int finished = 0;
+    for (int r = 0; r < rounds; ++r) {
+        ipasir2::async_solver solver(pool);
+        try {
+            solver.get().add_clauses(f.literals, f.offsets);
+        }
+        catch (ipasir2::error const& e) {
+            printf("%-32s %s\n", "async solve cancel", e.what());
+            return;
+        }
+        ipasir2::solve_future future = solver.solve();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        auto start = std::chrono::steady_clock::now();
+        future.cancel();
+        ipasir2::result res = future.get();
+        if (res != ipasir2::result::unknown) {
+            ++finished;
+            continue;
+        }
+        sampler.add(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+    }
+    sampler.report();
+    if (finished > 0) {
+        printf("%-32s %10d solve calls finished before cancel() or without terminate support\n", "async solve cancel", finished);
+    }
+}
+
+int main(int argc, char** argv) {
+    int32_t holes = argc > 1 ? std::stoi(argv[1]) : 10;
+    int rounds = argc > 2 ? std::stoi(argv[2]) : 20;
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "Solver: " << signature << std::endl;
+
+    latency_sampler::report_header();
+    bench_cancel(holes, rounds);
+}
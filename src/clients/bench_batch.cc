@@ -0,0 +1,66 @@
+/**
+ * MIT License
+ *
+ * Measures the throughput of a batch_solver (ipasir2_batch.hpp) with a growing number of replicas.
+ *
+ * Usage: bench_batch [queries] [max replicas]
+ *
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ipasir2.h"
+#include "ipasir2.hpp"
+#include "ipasir2_batch.hpp"
+#include "ipasir2_bench.h"
+
+
+// Throughput of a batch_solver answering independent assumption sets on one formula with a growing
+// number of replicas. The sets share prefixes of four literals, as queries enumerating cases do.
+// Reports the wall time per query and the speedup over one replica.
+void bench_batch(int queries, unsigned max_replicas) {
+    csr_formula f = random_ksat(250, 100, 3, 4);
+    std::mt19937 rng(5);
+    std::vector<std::vector<int32_t>> prefixes(32);
+    for (std::vector<int32_t>& prefix : prefixes) {
+        for (int k = 0; k < 4; ++k) {
+            prefix.push_back(rng() & 1 ? 1 + rng() % 100 : -static_cast<int32_t>(1 + rng() % 100));
+        }
+    }
+    std::vector<std::vector<int32_t>> batch;
+    for (int i = 0; i < queries; ++i) {
+        batch.push_back(prefixes[rng() % prefixes.size()]);
+        for (int k = 0; k < 2; ++k) {
+            batch.back().push_back(rng() & 1 ? 1 + rng() % 100 : -static_cast<int32_t>(1 + rng() % 100));
+        }
+    }
+    double single = 0;
+    for (unsigned replicas = 1; replicas <= max_replicas; replicas *= 2) {
+        ipasir2::batch_solver solver(replicas, [&](ipasir2::solver& s) { s.add_clauses(f.literals, f.offsets); });
+        auto start = std::chrono::steady_clock::now();
+        solver.solve(batch);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / queries;
+        single = replicas == 1 ? ns : single;
+        std::string name = "batch solve (" + std::to_string(replicas) + " replicas)";
+        printf("%-32s %10d %12s %12s %12.1f  speedup %.2f\n", name.c_str(), queries, "-", "-", ns, single / ns);
+    }
+}
+
+int main(int argc, char** argv) {
+    int queries = argc > 1 ? std::stoi(argv[1]) : 1000;
+    unsigned replicas = argc > 2 ? std::stoi(argv[2]) : std::max(2u, std::min(16u, std::thread::hardware_concurrency()));
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "Solver: " << signature << std::endl;
+
+    latency_sampler::report_header();
+    bench_batch(queries, replicas);
+}
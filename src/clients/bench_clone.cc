@@ -0,0 +1,69 @@
+/**
+ * MIT License
+ *
+ * Compares copying a loaded instance with ipasir2_clone() to rebuilding it from the formula.
+ *
+ * Usage: bench_clone [max clauses]
+ *
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "ipasir2.h"
+#include "ipasir2_util.h"
+#include "ipasir2_bench.h"
+
+
+// Cost of forking a loaded instance with ipasir2_clone() versus rebuilding it from scratch with
+// ipasir2_init() and ipasir2_add_clauses(), for growing formulas. Reports the best of three rounds in ns.
+void bench_clone(int32_t max_clauses) {
+    for (int32_t clauses = 10000; clauses <= max_clauses; clauses *= 10) {
+        csr_formula f = random_ksat(clauses, clauses / 4, 3, 6);
+        void* solver;
+        ipasir2_init(&solver);
+        ipasir2_add_formula(solver, f.literals.data(), f.offsets.data(), f.size());
+        double best_rebuild = -1;
+        double best_clone = -1;
+        ipasir2_errorcode err = IPASIR2_E_OK;
+        for (int r = 0; r < 3 && !err; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            void* rebuilt;
+            ipasir2_init(&rebuilt);
+            ipasir2_add_formula(rebuilt, f.literals.data(), f.offsets.data(), f.size());
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            best_rebuild = best_rebuild < 0 || ns < best_rebuild ? ns : best_rebuild;
+            ipasir2_release(rebuilt);
+
+            start = std::chrono::steady_clock::now();
+            void* clone;
+            err = ipasir2_clone != nullptr ? ipasir2_clone(solver, &clone) : IPASIR2_E_UNSUPPORTED;
+            ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            best_clone = best_clone < 0 || ns < best_clone ? ns : best_clone;
+            if (!err) {
+                ipasir2_release(clone);
+            }
+        }
+        ipasir2_release(solver);
+        std::string suffix = "(" + std::to_string(clauses) + " clauses)";
+        printf("%-32s %10d %12s %12s %12.1f\n", ("rebuild " + suffix).c_str(), 3, "-", "-", best_rebuild);
+        if (err) {
+            printf("%-32s %s\n", ("clone " + suffix).c_str(), ipasir2_errorcode_to_string(err).c_str());
+            return;
+        }
+        printf("%-32s %10d %12s %12s %12.1f\n", ("clone " + suffix).c_str(), 3, "-", "-", best_clone);
+    }
+}
+
+int main(int argc, char** argv) {
+    int32_t max_clauses = argc > 1 ? std::stoi(argv[1]) : 1000000;
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "Solver: " << signature << std::endl;
+
+    latency_sampler::report_header();
+    bench_clone(max_clauses);
+}
@@ -0,0 +1,92 @@
+/**
+ * MIT License
+ *
+ * Measures the cost of calling a backend through a backend_library function table instead of
+ * the linked ipasir2_* symbols, and the cost of loading a backend library.
+ *
+ * Usage: bench_dl <backend.so> [calls]
+ *
+ * The shared library should contain the same backend as the one the benchmark is linked to,
+ * so that both paths execute the same code and differ only in how the functions are reached.
+ *
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "ipasir2.h"
+#include "ipasir2_bench.h"
+#include "loader.h"
+
+
+// Per-call latencies of add, solve and value, calling the linked ipasir2_* functions if
+// \p library is null, and the function table of \p library otherwise.
+void bench_calls(backend_library const* library, char const* name, int calls) {
+    void* solver;
+    library ? library->init(&solver) : ipasir2_init(&solver);
+    std::mt19937 rng(1);
+    latency_sampler add(std::string("add ") + name);
+    for (int i = 0; i < calls; ++i) {
+        int32_t clause[2] = { static_cast<int32_t>(1 + rng() % 1000), -static_cast<int32_t>(1 + rng() % 1000) };
+        add.measure([&]() { return library ? library->add(solver, clause, 2, 0, nullptr) : ipasir2_add(solver, clause, 2, 0, nullptr); });
+    }
+    latency_sampler solve(std::string("solve ") + name);
+    latency_sampler value(std::string("value ") + name);
+    for (int i = 0; i < calls / 1000; ++i) {
+        int result;
+        int32_t lit = 1 + rng() % 1000;
+        solve.measure([&]() { return library ? library->solve(solver, &result, &lit, 1) : ipasir2_solve(solver, &result, &lit, 1); });
+        for (int32_t var = 1; var <= 100; ++var) {
+            int32_t v;
+            value.measure([&]() { return library ? library->value(solver, var, &v) : ipasir2_value(solver, var, &v); });
+        }
+    }
+    add.report();
+    solve.report();
+    value.report();
+    library ? library->release(solver) : ipasir2_release(solver);
+}
+
+void bench_load(std::string const& path, backend_library::isolation mode, char const* name, int rounds) {
+    latency_sampler load(name);
+    for (int r = 0; r < rounds; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        {
+            backend_library library(path, mode);
+        }
+        load.add(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+    }
+    load.report();
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <backend.so> [calls]" << std::endl;
+        return 1;
+    }
+    int calls = argc > 2 ? std::stoi(argv[2]) : 100000;
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "Linked solver: " << signature << std::endl;
+
+    try {
+        backend_library library(argv[1]);
+        std::cout << "Loaded solver: " << library.name() << " (" << library.path() << ")" << std::endl;
+
+        latency_sampler::report_header();
+        bench_calls(nullptr, "(linked)", calls);
+        bench_calls(&library, "(loaded)", calls);
+        // namespaces are not reclaimed, see loader.h
+        bench_load(argv[1], backend_library::OWN_NAMESPACE, "load + unload (dlmopen)", 4);
+        bench_load(argv[1], backend_library::SHARED_NAMESPACE, "load + unload (dlopen)", 20);
+    }
+    catch (std::runtime_error const& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
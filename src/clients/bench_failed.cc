@@ -0,0 +1,106 @@
+/**
+ * MIT License
+ *
+ * Compares probing each assumption with ipasir2_failed() against retrieving the core with ipasir2_failed_core(),
+ * for a small core under a growing number of assumptions.
+ *
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ipasir2.h"
+#include "ipasir2_util.h"
+
+
+const int32_t core_size = 5;
+
+template<typename F>
+double time_per_retrieval(F retrieve, int repeats) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        if (retrieve()) {
+            return -1;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / repeats;
+}
+
+int bench(int32_t n_assumptions, int repeats) {
+    void* solver;
+    ipasir2_init(&solver);
+
+    // Assuming variables 1..core_size true together falsifies the only clause
+    std::vector<int32_t> conflict;
+    for (int32_t var = 1; var <= core_size; ++var) {
+        conflict.push_back(-var);
+    }
+    ipasir2_add(solver, conflict.data(), conflict.size(), 0, nullptr);
+
+    std::vector<int32_t> assumptions;
+    for (int32_t var = n_assumptions; var >= 1; --var) {
+        assumptions.push_back(var);
+    }
+
+    int result;
+    ipasir2_errorcode err = ipasir2_solve(solver, &result, assumptions.data(), assumptions.size());
+    if (err || result != RESULT_UNSAT) {
+        std::cout << "ipasir2_solve() failed: " << err << ", result " << result << std::endl;
+        ipasir2_release(solver);
+        return 1;
+    }
+
+    std::vector<int32_t> core;
+    double probing = time_per_retrieval([&]() {
+        core.clear();
+        for (int32_t lit : assumptions) {
+            int failed;
+            ipasir2_errorcode err = ipasir2_failed(solver, lit, &failed);
+            if (err) return err;
+            if (failed) core.push_back(lit);
+        }
+        return IPASIR2_E_OK;
+    }, repeats);
+    size_t probed_size = core.size();
+
+    double direct = time_per_retrieval([&]() {
+        int32_t size = 0;
+        if (ipasir2_failed_core == nullptr) {
+            return IPASIR2_E_UNSUPPORTED;
+        }
+        ipasir2_errorcode err = ipasir2_failed_core(solver, nullptr, 0, &size);
+        if (err) return err;
+        core.resize(size);
+        return ipasir2_failed_core(solver, core.data(), size, &size);
+    }, repeats);
+
+    printf("%12d %10zu %16.2f", n_assumptions, probed_size, probing);
+    if (direct < 0) {
+        printf(" %20s\n", "unavailable");
+    } else {
+        printf(" %20.2f %9.1fx\n", direct, probing / direct);
+    }
+
+    ipasir2_release(solver);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int32_t max_assumptions = argc > 1 ? std::stoi(argv[1]) : 100000;
+    int repeats = argc > 2 ? std::stoi(argv[2]) : 20;
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "Solver: " << signature << std::endl;
+    printf("%12s %10s %16s %20s %10s\n", "assumptions", "core", "failed() [us]", "failed_core() [us]", "speedup");
+
+    for (int32_t n = 10; n <= max_assumptions; n *= 10) {
+        if (bench(n, repeats)) {
+            return 1;
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/**
+ * MIT License
+ *
+ * Measures the latency of short queries on instances taken from a solver_pool (ipasir2_pool.hpp)
+ * versus instances initialized for each query.
+ *
+ * Usage: bench_pool [queries]
+ *
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "ipasir2.h"
+#include "ipasir2.hpp"
+#include "ipasir2_pool.hpp"
+#include "ipasir2_util.h"
+#include "ipasir2_bench.h"
+
+
+// Latency of short queries on a fresh instance from ipasir2_init() versus one acquired from a
+// solver_pool, which initializes instances and releases returned ones on a background thread.
+// The queries are spaced by a short pause, giving the pool time to refill as in a service.
+void bench_pool(int queries) {
+    csr_formula f = random_ksat(40, 20, 3, 3);
+    using clock = std::chrono::steady_clock;
+    latency_sampler cold_init("ipasir2_init() + release()");
+    latency_sampler cold_query("query cold");
+    for (int i = 0; i < queries; ++i) {
+        auto start = clock::now();
+        void* solver;
+        ipasir2_init(&solver);
+        auto init = clock::now();
+        ipasir2_add_formula(solver, f.literals.data(), f.offsets.data(), f.size());
+        int result;
+        ipasir2_solve(solver, &result, nullptr, 0);
+        auto solved = clock::now();
+        ipasir2_release(solver);
+        auto end = clock::now();
+        cold_init.add(std::chrono::duration<double, std::nano>((init - start) + (end - solved)).count());
+        cold_query.add(std::chrono::duration<double, std::nano>(end - start).count());
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    cold_init.report();
+    cold_query.report();
+
+    ipasir2::solver_pool pool(ipasir2::config(), 16);
+    latency_sampler pooled_acquire("solver_pool acquire() + return");
+    latency_sampler pooled_query("query pooled");
+    for (int i = 0; i < queries; ++i) {
+        auto start = clock::now();
+        clock::time_point acquired, solved;
+        {
+            ipasir2::pooled_solver solver = pool.acquire();
+            acquired = clock::now();
+            solver->add_clauses(f.literals, f.offsets);
+            do_not_optimize(solver->solve());
+            solved = clock::now();
+        }
+        auto end = clock::now();
+        pooled_acquire.add(std::chrono::duration<double, std::nano>((acquired - start) + (end - solved)).count());
+        pooled_query.add(std::chrono::duration<double, std::nano>(end - start).count());
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    pooled_acquire.report();
+    pooled_query.report();
+    ipasir2::solver_pool::stats stats = pool.statistics();
+    printf("%-32s %10llu pooled, %llu cold\n", "solver_pool acquire()", static_cast<unsigned long long>(stats.pooled), static_cast<unsigned long long>(stats.cold));
+}
+
+int main(int argc, char** argv) {
+    int queries = argc > 1 ? std::stoi(argv[1]) : 1000;
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "Solver: " << signature << std::endl;
+
+    latency_sampler::report_header();
+    bench_pool(queries);
+}
@@ -0,0 +1,94 @@
+/**
+ * MIT License
+ *
+ * Measures the slowdown of solving while writing a DRAT proof, as text from the export callback
+ * and in binary format with the asynchronous proof_writer.
+ *
+ * Usage: bench_proof [pigeonhole holes]
+ *
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "ipasir2.h"
+#include "ipasir2_util.h"
+#include "ipasir2_bench.h"
+#include "proof_writer.h"
+
+
+// Solve time on a pigeonhole formula without a proof, with a synchronous text DRAT proof written by
+// fprintf() from the export callback, and with a binary DRAT proof_writer. Reports the best of three
+// rounds in ns and the slowdown relative to solving without a proof.
+void bench_proof(int32_t holes) {
+    csr_formula f = pigeonhole(holes);
+    char const* path = "ipasir2_bench_proof.drat";
+    char const* names[3] = { "solve, no proof", "solve, text DRAT (fprintf)", "solve, binary DRAT (proof_writer)" };
+    double best[3] = { -1, -1, -1 };
+    uint64_t bytes[3] = { 0, 0, 0 };
+    for (int r = 0; r < 3; ++r) {
+        for (int mode = 0; mode < 3; ++mode) {
+            void* solver;
+            ipasir2_init(&solver);
+            FILE* text = nullptr;
+            std::unique_ptr<proof_writer> proof;
+            ipasir2_errorcode err = IPASIR2_E_OK;
+            if (mode == 1) {
+                text = fopen(path, "w");
+                err = ipasir2_set_export(solver, text, -1, [](void* data, int32_t const* clause, int32_t len, void*) {
+                    for (int32_t i = 0; i < len; ++i) {
+                        fprintf(static_cast<FILE*>(data), "%d ", clause[i]);
+                    }
+                    fputs("0\n", static_cast<FILE*>(data));
+                });
+            }
+            else if (mode == 2) {
+                proof.reset(new proof_writer(path, proof_writer::DRAT));
+                err = proof->attach(solver);
+            }
+            if (err) {
+                printf("%-32s %s\n", names[mode], ipasir2_errorcode_to_string(err).c_str());
+                if (text != nullptr) {
+                    fclose(text);
+                }
+                ipasir2_release(solver);
+                remove(path);
+                return;
+            }
+            ipasir2_add_formula(solver, f.literals.data(), f.offsets.data(), f.size());
+            int result;
+            auto start = std::chrono::steady_clock::now();
+            ipasir2_solve(solver, &result, nullptr, 0);
+            if (text != nullptr) {
+                bytes[mode] = ftell(text);
+                fclose(text);
+            }
+            if (proof) {
+                proof->close();
+                bytes[mode] = proof->statistics().bytes;
+            }
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            ipasir2_release(solver);
+            best[mode] = best[mode] < 0 || ns < best[mode] ? ns : best[mode];
+        }
+    }
+    remove(path);
+    for (int mode = 0; mode < 3; ++mode) {
+        printf("%-32s %10llu %12s %12s %12.1f  slowdown %.2f\n", names[mode], static_cast<unsigned long long>(bytes[mode]), "-", "-",
+            best[mode], best[mode] / best[0]);
+    }
+}
+
+int main(int argc, char** argv) {
+    int32_t holes = argc > 1 ? std::stoi(argv[1]) : 8;
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "Solver: " << signature << std::endl;
+
+    latency_sampler::report_header();
+    bench_proof(holes);
+}
@@ -0,0 +1,147 @@
+/**
+ * MIT License
+ *
+ * Measures clause sharing between solver instances: export into a clause_ring per clause
+ * versus per batch, the solve time with either export callback, and the clause_filter.
+ *
+ * Usage: bench_share [clauses per thread] [pigeonhole holes] [threads]
+ *
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ipasir2.h"
+#include "ipasir2_util.h"
+#include "ipasir2_bench.h"
+#include "clause_filter.h"
+#include "clause_ring.h"
+
+
+// Export of learned clauses into a clause_ring from several producer threads, invoking the
+// callback once per clause versus once per batch of clauses. The callbacks are called through
+// function pointers like a solver would call them. Reports the wall time per exported clause.
+void bench_export_ring(int clauses, int threads, int32_t batch) {
+    csr_formula pool = random_ksat(4096, 1000, 3, 1);
+    for (bool batched : { false, true }) {
+        clause_ring ring(1 << 16, 8);
+        std::vector<clause_ring::endpoint> endpoints(threads);
+        void (*volatile export_clause)(void*, int32_t const*, int32_t, void*) = clause_ring::export_callback;
+        void (*volatile export_batch)(void*, int32_t const*, int32_t const*, int32_t, void* const*) = clause_ring::export_batch_callback;
+        std::vector<std::thread> producers;
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < threads; ++t) {
+            producers.emplace_back([&, t]() {
+                clause_ring::endpoint& e = endpoints[t];
+                e.ring = &ring;
+                e.position.id = t;
+                int32_t const* lits = pool.literals.data();
+                int32_t const* offsets = pool.offsets.data();
+                for (int i = 0; i < clauses; i += batch) {
+                    int32_t first = i % (pool.size() - batch);
+                    if (batched) {
+                        export_batch(&e, lits, offsets + first, batch, nullptr);
+                    }
+                    else {
+                        for (int32_t k = first; k < first + batch; ++k) {
+                            export_clause(&e, lits + offsets[k], offsets[k + 1] - offsets[k], nullptr);
+                        }
+                    }
+                }
+            });
+        }
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        std::string name = std::string(batched ? "ring export batch" : "ring export clause") + " (" + std::to_string(threads) + " thr)";
+        printf("%-32s %10llu %12s %12s %12.2f\n", name.c_str(), static_cast<unsigned long long>(ring.pushed()), "-", "-", ns / ring.pushed());
+    }
+}
+
+// Solve time of the backend with the per-clause export callback versus the batched one,
+// both feeding a clause_ring. Reports the number of exported clauses and the solve time per exported clause.
+void bench_export_solver(int32_t holes) {
+    csr_formula f = pigeonhole(holes);
+    for (bool batched : { false, true }) {
+        char const* name = batched ? "solve with export_batch()" : "solve with export()";
+        void* solver;
+        ipasir2_init(&solver);
+        ipasir2_add_formula(solver, f.literals.data(), f.offsets.data(), f.size());
+        clause_ring ring(1 << 16, 32);
+        clause_ring::endpoint e;
+        e.ring = &ring;
+        e.position.id = 0;
+        ipasir2_errorcode err = IPASIR2_E_UNSUPPORTED;
+        if (!batched) {
+            err = ipasir2_set_export(solver, &e, ring.max_length(), clause_ring::export_callback);
+        }
+        else if (ipasir2_set_export_batch != nullptr) {
+            err = ipasir2_set_export_batch(solver, &e, ring.max_length(), clause_ring::export_batch_callback);
+        }
+        if (err) {
+            printf("%-32s %s\n", name, ipasir2_errorcode_to_string(err).c_str());
+            ipasir2_release(solver);
+            continue;
+        }
+        int result;
+        auto start = std::chrono::steady_clock::now();
+        ipasir2_solve(solver, &result, nullptr, 0);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        ipasir2_release(solver);
+        if (e.exported == 0) {
+            printf("%-32s no clauses exported\n", name);
+            continue;
+        }
+        printf("%-32s %10llu %12s %12s %12.1f\n", name, static_cast<unsigned long long>(e.exported), "-", "-", ns / e.exported);
+    }
+}
+
+// Throughput and hit rate of the clause_filter with several threads checking clauses drawn from a
+// pool of distinct clauses, as if every thread learned the same clauses. Smaller pools mean more duplicates.
+void bench_filter(int clauses, int threads) {
+    for (int32_t distinct : { 1 << 12, 1 << 16, 1 << 20 }) {
+        csr_formula pool = random_ksat(distinct, 100000, 4, 2);
+        clause_filter filter(1 << 20);
+        std::vector<std::thread> workers;
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                std::mt19937 rng(t);
+                for (int i = 0; i < clauses; ++i) {
+                    int32_t k = rng() % distinct;
+                    filter.insert(pool.literals.data() + pool.offsets[k], pool.offsets[k + 1] - pool.offsets[k]);
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        clause_filter::stats stats = filter.statistics();
+        std::string name = "filter " + std::to_string(distinct) + " distinct (" + std::to_string(threads) + " thr)";
+        printf("%-32s %10llu %12s %12s %12.2f  hit rate %.1f%%\n", name.c_str(), static_cast<unsigned long long>(stats.checked), "-", "-",
+            ns / stats.checked, 100 * stats.hit_rate());
+    }
+}
+
+int main(int argc, char** argv) {
+    int clauses = argc > 1 ? std::stoi(argv[1]) : 1000000;
+    int32_t holes = argc > 2 ? std::stoi(argv[2]) : 8;
+    int threads = argc > 3 ? std::stoi(argv[3]) : std::max(2u, std::min(8u, std::thread::hardware_concurrency()));
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "Solver: " << signature << std::endl;
+
+    latency_sampler::report_header();
+    bench_export_ring(clauses, threads, 64);
+    bench_export_solver(holes);
+    bench_filter(clauses, threads);
+}
@@ -0,0 +1,90 @@
+/**
+ * MIT License
+ *
+ * Measures the recording overhead of the tracing shim (src/trace) on clause ingestion with ipasir2_add().
+ *
+ * Usage: bench_trace <libipasir2_trace.so> <backend.so> [clauses] [variables] [rounds]
+ *
+ * The benchmark loads the backend library directly and the tracing shim configured to forward to
+ * the same library (IPASIR2_TRACE_BACKEND), so both paths call the backend through a function table
+ * and differ only in the recording. The linked backend is timed as a reference. Preloading the shim
+ * with LD_PRELOAD does not work here, since the clients link their backend statically.
+ *
+ * The trace is written to IPASIR2_TRACE_FILE, /dev/null if it is not set. Writing happens on the
+ * shim's background thread, so it only shows in the timings if the writer falls behind.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "ipasir2.h"
+#include "ipasir2_bench.h"
+#include "loader.h"
+
+
+// best time in nanoseconds of adding all clauses of \p f one by one to a fresh instance,
+// through the function table of \p library, or the linked ipasir2_* functions if it is null
+double time_add(backend_library const* library, csr_formula const& f, int rounds) {
+    double best = 0;
+    for (int r = 0; r < rounds; ++r) {
+        void* solver;
+        library ? library->init(&solver) : ipasir2_init(&solver);
+        auto start = std::chrono::steady_clock::now();
+        for (int32_t i = 0; i < f.size(); ++i) {
+            int32_t const* clause = f.literals.data() + f.offsets[i];
+            int32_t len = f.offsets[i + 1] - f.offsets[i];
+            library ? library->add(solver, clause, len, 0, nullptr) : ipasir2_add(solver, clause, len, 0, nullptr);
+        }
+        auto end = std::chrono::steady_clock::now();
+        library ? library->release(solver) : ipasir2_release(solver);
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        if (r == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <libipasir2_trace.so> <backend.so> [clauses] [variables] [rounds]" << std::endl;
+        return 1;
+    }
+    int32_t n_clauses = argc > 3 ? std::stoi(argv[3]) : 1000000;
+    int32_t n_vars = argc > 4 ? std::stoi(argv[4]) : n_clauses / 4;
+    int rounds = argc > 5 ? std::stoi(argv[5]) : 5;
+
+    // read by the shim when it resolves its backend, i.e., at its first call
+    setenv("IPASIR2_TRACE_BACKEND", argv[2], 1);
+    setenv("IPASIR2_TRACE_FILE", "/dev/null", 0);
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "Linked solver: " << signature << std::endl;
+    std::cout << "Formula: " << n_clauses << " random 3-clauses over " << n_vars << " variables, best of " << rounds << " rounds" << std::endl;
+
+    csr_formula f = random_ksat(n_clauses, n_vars, 3, 42);
+    try {
+        backend_library backend(argv[2]);
+        backend_library traced(argv[1]);
+        std::cout << "Loaded solver: " << backend.name() << " (" << backend.path() << ")" << std::endl;
+        std::cout << "Traced solver: " << traced.name() << " (" << traced.path() << ")" << std::endl;
+
+        double linked = time_add(nullptr, f, rounds);
+        double loaded = time_add(&backend, f, rounds);
+        double recorded = time_add(&traced, f, rounds);
+        std::cout << "ipasir2_add() (linked): " << linked / f.size() << " ns/clause" << std::endl;
+        std::cout << "ipasir2_add() (loaded): " << loaded / f.size() << " ns/clause" << std::endl;
+        std::cout << "ipasir2_add() (traced): " << recorded / f.size() << " ns/clause" << std::endl;
+        std::cout << "Tracing overhead: " << 100 * (recorded - loaded) / loaded << " %" << std::endl;
+    }
+    catch (std::runtime_error const& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
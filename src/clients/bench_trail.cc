@@ -0,0 +1,88 @@
+/**
+ * MIT License
+ *
+ * Measures incremental solve calls with long shared assumption prefixes, with and without
+ * the option ipasir.assumptions.reuse_trail.
+ *
+ * Usage: bench_trail [calls]
+ *
+ */
+
+#include <stdio.h>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ipasir2.h"
+#include "ipasir2_util.h"
+#include "ipasir2_bench.h"
+
+
+// Incremental solve calls whose assumptions share a long prefix with the previous call, with and
+// without ipasir.assumptions.reuse_trail. Each of the 200 assumptions implies a chain of 50 literals,
+// and only the last 10 assumptions change between calls. Where ipasir.assumptions.fixed is supported,
+// the literals implied by the assumptions are counted with the fixed() callback to show the
+// propagations saved by keeping the trail.
+void bench_trail_reuse(int calls) {
+    int32_t const assumed = 200;
+    int32_t const shared = 190;
+    int32_t const chain = 50;
+    csr_formula f;
+    for (int32_t i = 0; i < assumed; ++i) {
+        int32_t previous = i + 1;
+        for (int32_t j = 0; j < chain; ++j) {
+            int32_t next = assumed + i * chain + j + 1;
+            f.add({ -previous, next });
+            previous = next;
+        }
+    }
+
+    for (int reuse = 0; reuse <= 1; ++reuse) {
+        char const* name = reuse ? "solve, prefix trail reused" : "solve, prefix propagated";
+        void* solver;
+        ipasir2_init(&solver);
+        ipasir2_option const* handle;
+        if (reuse && (ipasir2_get_option_handle(solver, ipasir2_standard_option_names[IPASIR2_O_ASSUMPTIONS_REUSE_TRAIL], &handle) != IPASIR2_E_OK
+                || ipasir2_set_option(solver, handle, 1, 0) != IPASIR2_E_OK)) {
+            printf("%-32s unavailable\n", name);
+            ipasir2_release(solver);
+            return;
+        }
+        uint64_t implied = 0;
+        bool counting = ipasir2_get_option_handle(solver, ipasir2_standard_option_names[IPASIR2_O_ASSUMPTIONS_FIXED], &handle) == IPASIR2_E_OK
+            && ipasir2_set_option(solver, handle, 1, 0) == IPASIR2_E_OK
+            && ipasir2_set_fixed(solver, &implied, [](void* data, int32_t) { ++*static_cast<uint64_t*>(data); }) == IPASIR2_E_OK;
+        ipasir2_add_formula(solver, f.literals.data(), f.offsets.data(), f.size());
+
+        std::mt19937 rng(7);
+        std::vector<int32_t> assumptions;
+        for (int32_t i = 1; i <= assumed; ++i) {
+            assumptions.push_back(i);
+        }
+        latency_sampler sampler(name);
+        for (int i = 0; i < calls; ++i) {
+            for (int32_t k = shared; k < assumed; ++k) {
+                assumptions[k] = rng() & 1 ? k + 1 : -(k + 1);
+            }
+            int result;
+            sampler.measure([&]() { return ipasir2_solve(solver, &result, assumptions.data(), assumed); });
+        }
+        sampler.report();
+        if (counting) {
+            printf("%-32s %10d %12s %12s %12.1f  implied literals per call\n", name, calls, "-", "-", static_cast<double>(implied) / calls);
+        }
+        ipasir2_release(solver);
+    }
+}
+
+int main(int argc, char** argv) {
+    int calls = argc > 1 ? std::stoi(argv[1]) : 1000;
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "Solver: " << signature << std::endl;
+
+    latency_sampler::report_header();
+    bench_trail_reuse(calls);
+}
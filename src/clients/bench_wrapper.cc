@@ -0,0 +1,88 @@
+/**
+ * MIT License
+ *
+ * Measures the callback dispatch cost of the trampolines generated by the C++ wrapper (ipasir2.hpp).
+ *
+ * Usage: bench_wrapper [calls]
+ *
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "ipasir2.h"
+#include "ipasir2.hpp"
+#include "ipasir2_bench.h"
+
+
+struct poll_counter {
+    uint64_t polls = 0;
+    uint64_t literals = 0;
+
+    bool poll() {
+        return ++polls == 0;
+    }
+
+    static int terminate(void* data) {
+        return static_cast<poll_counter*>(data)->poll();
+    }
+
+    static void export_clause(void* data, int32_t const*, int32_t len, void*) {
+        static_cast<poll_counter*>(data)->literals += len;
+    }
+};
+
+// Calls a terminate callback through a function pointer, as the solver does, and returns the time per call in ns
+double dispatch_terminate(int (*volatile callback)(void*), void* data, int calls) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; ++i) {
+        do_not_optimize(callback(data));
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls;
+}
+
+double dispatch_export(void (*volatile callback)(void*, int32_t const*, int32_t, void*), void* data, int calls) {
+    int32_t clause[3] = { 1, -2, 3 };
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; ++i) {
+        callback(data, clause, 3, nullptr);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls;
+}
+
+// Callback dispatch cost of the trampolines generated by the C++ wrapper (ipasir2.hpp) compared to
+// hand-written static trampolines and to a trampoline calling a std::function
+void bench_wrapper_dispatch(int calls) {
+    poll_counter counter;
+    uint64_t polls = 0;
+    uint64_t literals = 0;
+    auto terminate = [&polls]() { return ++polls == 0; };
+    auto export_clause = [&literals](ipasir2::literals clause, void*) { literals += clause.size(); };
+    std::function<bool()> function = terminate;
+    int (*function_trampoline)(void*) = [](void* data) { return static_cast<int>((*static_cast<std::function<bool()>*>(data))()); };
+
+    printf("%-32s %10d %12s %12s %12.2f\n", "terminate hand-written", calls, "-", "-", dispatch_terminate(poll_counter::terminate, &counter, calls));
+    printf("%-32s %10d %12s %12s %12.2f\n", "terminate wrapper lambda", calls, "-", "-",
+        dispatch_terminate(ipasir2::trampoline<decltype(terminate)>::terminate, &terminate, calls));
+    printf("%-32s %10d %12s %12s %12.2f\n", "terminate wrapper member", calls, "-", "-",
+        dispatch_terminate(ipasir2::member_trampoline<&poll_counter::poll, poll_counter>::terminate, &counter, calls));
+    printf("%-32s %10d %12s %12s %12.2f\n", "terminate std::function", calls, "-", "-", dispatch_terminate(function_trampoline, &function, calls));
+    printf("%-32s %10d %12s %12s %12.2f\n", "export hand-written", calls, "-", "-", dispatch_export(poll_counter::export_clause, &counter, calls));
+    printf("%-32s %10d %12s %12s %12.2f\n", "export wrapper lambda", calls, "-", "-",
+        dispatch_export(ipasir2::trampoline<decltype(export_clause)>::clause, &export_clause, calls));
+    do_not_optimize(counter.literals + literals);
+}
+
+int main(int argc, char** argv) {
+    int calls = argc > 1 ? std::stoi(argv[1]) : 10000000;
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "Solver: " << signature << std::endl;
+
+    latency_sampler::report_header();
+    bench_wrapper_dispatch(calls);
+}
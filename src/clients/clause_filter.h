@@ -0,0 +1,163 @@
+/**
+ * MIT License
+ *
+ * Concurrent filter for recently shared clauses, placed between the export callbacks of the
+ * solver instances and the clause exchange, e.g. in front of clause_ring::push().
+ *
+ * Clauses are hashed independently of the order of their literals. The filter is split into
+ * shards selected by the hash, and each shard is a set-associative table of atomic entries
+ * holding a 32-bit fingerprint and the low 32 bits of the epoch in which the clause was first
+ * seen. The shard and the bucket are taken from the low half of the hash and the fingerprint
+ * from the high half, so entries of one bucket differ in all bits of their fingerprints.
+ * A clause whose fingerprint is found with an age of at most max_age epochs is rejected as
+ * duplicate. Each shard advances its epoch after a fixed number of checks, so entries age out
+ * as new clauses arrive; advance_epoch() ages all shards at once, e.g. after a round of solving.
+ * Ages are computed modulo 2^32 epochs, so an entry could only look fresh again after billions
+ * of epochs without being overwritten.
+ *
+ * The filter never blocks. Concurrent checks of the same clause may both accept it, and
+ * fingerprint collisions may reject a new clause, both of which are harmless for sharing.
+ *
+ */
+
+#ifndef IPASIR2_CLAUSE_FILTER_H
+#define IPASIR2_CLAUSE_FILTER_H
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+
+
+class clause_filter {
+public:
+    struct stats {
+        uint64_t checked = 0;
+        uint64_t rejected = 0;
+
+        double hit_rate() const {
+            return checked > 0 ? static_cast<double>(rejected) / checked : 0;
+        }
+    };
+
+    /**
+     * \p capacity is the total number of entries and \p shards the number of shards, both rounded up to powers of two.
+     * Entries older than \p max_age epochs are ignored. Each shard advances its epoch after \p epoch_length checks,
+     * 0 chooses half the number of entries of a shard.
+     */
+    clause_filter(uint32_t capacity, uint32_t shards = 64, uint32_t max_age = 4, uint32_t epoch_length = 0) : m_max_age(max_age) {
+        uint32_t n_shards = round_up(shards);
+        uint32_t entries = round_up(capacity / n_shards);
+        entries = entries < ways ? ways : entries;
+        m_shard_mask = n_shards - 1;
+        m_shard_bits = 0;
+        while ((1u << m_shard_bits) < n_shards) {
+            ++m_shard_bits;
+        }
+        m_bucket_mask = entries / ways - 1;
+        m_epoch_length = epoch_length > 0 ? epoch_length : entries / 2;
+        m_shards.reset(new shard[n_shards]);
+        for (uint32_t i = 0; i < n_shards; ++i) {
+            m_shards[i].entries.reset(new std::atomic<uint64_t>[entries]);
+            for (uint32_t j = 0; j < entries; ++j) {
+                m_shards[i].entries[j].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // hash of the clause which does not depend on the order of its literals
+    static uint64_t hash(int32_t const* clause, int32_t len) {
+        uint64_t h = len;
+        for (int32_t i = 0; i < len; ++i) {
+            h += mix(static_cast<uint32_t>(clause[i]));
+        }
+        return mix(h);
+    }
+
+    /**
+     * Returns true if the clause was not seen in the last max_age epochs and records it,
+     * returns false if it is a recent duplicate.
+     */
+    bool insert(int32_t const* clause, int32_t len) {
+        uint64_t h = hash(clause, len);
+        shard& s = m_shards[h & m_shard_mask];
+        uint64_t key = h & ~epoch_mask;
+        key = key != 0 ? key : epoch_mask + 1;
+
+        uint64_t checked = s.checked.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (checked % m_epoch_length == 0) {
+            s.epoch.fetch_add(1, std::memory_order_relaxed);
+        }
+        uint64_t epoch = s.epoch.load(std::memory_order_relaxed);
+
+        std::atomic<uint64_t>* bucket = &s.entries[((static_cast<uint32_t>(h) >> m_shard_bits) & m_bucket_mask) * ways];
+        uint32_t victim = 0;
+        uint64_t victim_age = 0;
+        for (uint32_t i = 0; i < ways; ++i) {
+            uint64_t entry = bucket[i].load(std::memory_order_relaxed);
+            uint64_t age = entry == 0 ? epoch_mask + 1 : (epoch - entry) & epoch_mask;
+            if (entry != 0 && (entry & ~epoch_mask) == key && age <= m_max_age) {
+                s.rejected.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (age > victim_age) {
+                victim = i;
+                victim_age = age;
+            }
+        }
+        bucket[victim].store(key | (epoch & epoch_mask), std::memory_order_relaxed);
+        return true;
+    }
+
+    // ages all entries by one epoch
+    void advance_epoch() {
+        for (uint32_t i = 0; i <= m_shard_mask; ++i) {
+            m_shards[i].epoch.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    stats statistics() const {
+        stats result;
+        for (uint32_t i = 0; i <= m_shard_mask; ++i) {
+            result.checked += m_shards[i].checked.load(std::memory_order_relaxed);
+            result.rejected += m_shards[i].rejected.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+private:
+    static const uint32_t ways = 4;
+    static const uint64_t epoch_mask = 0xffffffff;  // the low half of an entry, the high half is the fingerprint
+
+    struct alignas(64) shard {
+        std::atomic<uint64_t> epoch { 0 };
+        std::atomic<uint64_t> checked { 0 };
+        std::atomic<uint64_t> rejected { 0 };
+        std::unique_ptr<std::atomic<uint64_t>[]> entries;
+    };
+
+    static uint32_t round_up(uint32_t n) {
+        uint32_t size = 1;
+        while (size < n) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    uint32_t m_max_age;
+    uint32_t m_shard_mask;
+    uint32_t m_shard_bits;
+    uint64_t m_bucket_mask;
+    uint64_t m_epoch_length;
+    std::unique_ptr<shard[]> m_shards;
+};
+
+#endif // IPASIR2_CLAUSE_FILTER_H
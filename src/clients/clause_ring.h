@@ -0,0 +1,352 @@
+/**
+ * MIT License
+ *
+ * Clause exchange buffer for connecting ipasir2_set_export() to ipasir2_set_import()
+ * across solver instances running on different threads.
+ *
+ * The ring is a broadcast buffer: every clause pushed by one producer is seen by every
+ * reader, except readers attached to the same solver instance. Clause payloads live in a
+ * slab allocated once at construction, so pushing a clause never allocates. When a reader
+ * falls behind by more than the capacity of the ring, the oldest clauses are overwritten
+ * and the reader skips them, which is the usual trade-off in clause sharing.
+ *
+ * Slots are protected by sequence numbers (seqlock): a writer marks a slot odd while
+ * copying and publishes it with an even sequence number derived from its position.
+ * Readers copy optimistically and retry if the sequence number changed, they never block
+ * writers. Writers never wait for each other either: a writer whose slot is still being
+ * filled by an older clause, which happens if the ring wraps around during the copy, drops
+ * its clause and marks the position as dropped, so that readers skip it.
+ *
+ * Clause metadata (ipasir2_clause_meta, see the option ipasir.proofmeta.clause) is copied
+ * into the slot together with the literals, so the sender's struct need not outlive the
+ * callback. Proof hints are not copied. The ring rejects clauses which are only
+ * satisfiability-preserving, and, if an LBD limit is set, clauses whose known LBD exceeds it.
+ *
+ */
+
+#ifndef IPASIR2_CLAUSE_RING_H
+#define IPASIR2_CLAUSE_RING_H
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "ipasir2.h"
+#include "ipasir2_optional.h"
+#include "clause_filter.h"
+
+
+class clause_ring {
+public:
+    /**
+     * Reading position of one consumer. Each thread needs its own reader.
+     * Clauses pushed with the reader's \p id are skipped.
+     */
+    struct reader {
+        int32_t id = -1;
+        uint64_t cursor = 0;
+        uint64_t lost = 0;  // clauses overwritten before this reader got to them
+        ipasir2_clause_meta meta {};    // metadata of the last clause returned by pop()
+    };
+
+    /**
+     * Connects one solver instance to the ring. Attach it with attach() and keep it alive
+     * (and at the same address) as long as the solver may call its callbacks.
+     * If \p filter is set, exported clauses which it rejects as recent duplicates are not pushed.
+     * Set \p clause_meta if the solver's proofmeta pointers refer to ipasir2_clause_meta, i.e.,
+     * if the option ipasir.proofmeta.clause was set to 1.
+     */
+    struct endpoint {
+        clause_ring* ring = nullptr;
+        void* solver = nullptr;
+        clause_filter* filter = nullptr;
+        reader position;
+        std::vector<int32_t> buffer;
+        std::vector<int32_t> batch_literals;    // filtered batch
+        std::vector<int32_t> batch_offsets;
+        std::vector<ipasir2_clause_meta const*> batch_meta;
+        uint64_t exported = 0;
+        uint64_t filtered = 0;
+        uint64_t imported = 0;
+        bool batched = false;   // whether the solver exports through ipasir2_set_export_batch()
+        bool clause_meta = false;
+    };
+
+    /**
+     * \p capacity is rounded up to a power of two. Clauses longer than \p max_length are not stored.
+     */
+    clause_ring(uint32_t capacity, int32_t max_length) : m_max_length(max_length) {
+        uint32_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_slots.reset(new slot[size]);
+        m_slab.reset(new std::atomic<int32_t>[static_cast<size_t>(size) * max_length]);
+    }
+
+    int32_t max_length() const {
+        return m_max_length;
+    }
+
+    // clauses with a known LBD above \p max_lbd are rejected, -1 disables the limit
+    void set_max_lbd(int32_t max_lbd) {
+        m_max_lbd = max_lbd;
+    }
+
+    // whether a clause of length \p len with metadata \p meta (may be nullptr) can be stored
+    bool accepts(int32_t len, ipasir2_clause_meta const* meta) const {
+        if (len > m_max_length) {
+            return false;
+        }
+        if (meta == nullptr) {
+            return true;
+        }
+        return meta->redundancy != IPASIR2_R_SATISFIABLE && (m_max_lbd < 0 || meta->lbd <= m_max_lbd);
+    }
+
+    // number of clauses pushed so far
+    uint64_t pushed() const {
+        return m_head.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Copies the clause into the ring. Thread-safe, never allocates.
+     * Returns false if the clause is not accepted, or if its slot was still being written or already
+     * overwritten by a newer clause.
+     * \p meta may be nullptr, its content is copied.
+     */
+    bool push(int32_t producer, int32_t const* clause, int32_t len, ipasir2_clause_meta const* meta) {
+        if (!accepts(len, meta)) {
+            return false;
+        }
+        return store(m_head.fetch_add(1, std::memory_order_relaxed), producer, clause, len, meta);
+    }
+
+    /**
+     * Copies a batch of clauses given in CSR layout (see ipasir2_set_export_batch()) into the ring.
+     * The positions of all clauses are reserved at once, so producers contend on the head only once per batch.
+     * Returns the number of clauses stored.
+     */
+    int32_t push_batch(int32_t producer, int32_t const* literals, int32_t const* offsets, int32_t count,
+        ipasir2_clause_meta const* const* meta) {
+        int32_t storable = 0;
+        for (int32_t i = 0; i < count; ++i) {
+            storable += accepts(offsets[i + 1] - offsets[i], meta != nullptr ? meta[i] : nullptr);
+        }
+        if (storable == 0) {
+            return 0;
+        }
+        uint64_t pos = m_head.fetch_add(storable, std::memory_order_relaxed);
+        int32_t stored = 0;
+        for (int32_t i = 0; i < count; ++i) {
+            int32_t len = offsets[i + 1] - offsets[i];
+            ipasir2_clause_meta const* clause_meta = meta != nullptr ? meta[i] : nullptr;
+            if (accepts(len, clause_meta)) {
+                stored += store(pos++, producer, literals + offsets[i], len, clause_meta);
+            }
+        }
+        return stored;
+    }
+
+    /**
+     * Copies the next clause not pushed by \p r.id into \p buffer, which must hold max_length() literals.
+     * \p meta is set to the copy of the clause's metadata in \p r, or to nullptr if it was pushed without.
+     * Returns false if no such clause is available yet.
+     */
+    bool pop(reader& r, int32_t* buffer, int32_t& len, ipasir2_clause_meta*& meta) {
+        while (true) {
+            uint64_t head = m_head.load(std::memory_order_acquire);
+            if (r.cursor >= head) {
+                return false;
+            }
+            if (head - r.cursor > m_mask + 1) {
+                r.lost += head - (m_mask + 1) - r.cursor;
+                r.cursor = head - (m_mask + 1);
+            }
+            slot& s = m_slots[r.cursor & m_mask];
+            uint64_t published = 2 * r.cursor + 2;
+            uint64_t seq = s.seq.load(std::memory_order_acquire);
+            if (seq < published && s.dropped.load(std::memory_order_acquire) <= r.cursor) {
+                // the producer of this position has not finished copying
+                return false;
+            }
+            if (seq == published) {
+                len = s.len.load(std::memory_order_relaxed);
+                int32_t producer = s.producer.load(std::memory_order_relaxed);
+                bool has_meta = s.has_meta.load(std::memory_order_relaxed);
+                r.meta.id = s.id.load(std::memory_order_relaxed);
+                r.meta.lbd = s.lbd.load(std::memory_order_relaxed);
+                r.meta.activity = s.activity.load(std::memory_order_relaxed);
+                r.meta.redundancy = static_cast<ipasir2_redundancy>(s.redundancy.load(std::memory_order_relaxed));
+                meta = has_meta ? &r.meta : nullptr;
+                std::atomic<int32_t> const* lits = &m_slab[(r.cursor & m_mask) * m_max_length];
+                for (int32_t i = 0; i < len; ++i) {
+                    buffer[i] = lits[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (s.seq.load(std::memory_order_relaxed) == published) {
+                    ++r.cursor;
+                    if (producer != r.id) {
+                        return true;
+                    }
+                    continue;
+                }
+            }
+            // overwritten by a newer clause
+            ++r.lost;
+            ++r.cursor;
+        }
+    }
+
+    /**
+     * Registers the export and import callbacks of \p e.solver with the ring.
+     * Batched export is preferred, the per-clause export callback is used if the solver does not support it.
+     * The endpoint's reader starts at the current end of the ring.
+     */
+    ipasir2_errorcode attach(endpoint& e, void* solver, int32_t id) {
+        e.ring = this;
+        e.solver = solver;
+        e.position.id = id;
+        e.position.cursor = pushed();
+        e.buffer.resize(m_max_length);
+        e.batched = ipasir2_set_export_batch != nullptr;
+        ipasir2_errorcode ret = IPASIR2_E_UNSUPPORTED;
+        if (e.batched) {
+            ret = ipasir2_set_export_batch(solver, &e, m_max_length, export_batch_callback);
+        }
+        if (ret == IPASIR2_E_UNSUPPORTED) {
+            e.batched = false;
+            ret = ipasir2_set_export(solver, &e, m_max_length, export_callback);
+        }
+        if (ret) {
+            return ret;
+        }
+        return ipasir2_set_import(solver, &e, import_callback);
+    }
+
+    static void export_callback(void* data, int32_t const* clause, int32_t len, void* proofmeta) {
+        endpoint* e = static_cast<endpoint*>(data);
+        ipasir2_clause_meta const* meta = e->clause_meta ? static_cast<ipasir2_clause_meta const*>(proofmeta) : nullptr;
+        if (!e->ring->accepts(len, meta)) {
+            return;
+        }
+        if (e->filter != nullptr && !e->filter->insert(clause, len)) {
+            ++e->filtered;
+            return;
+        }
+        e->exported += e->ring->push(e->position.id, clause, len, meta);
+    }
+
+    static void export_batch_callback(void* data, int32_t const* literals, int32_t const* offsets, int32_t count,
+        void* const* proofmeta) {
+        endpoint* e = static_cast<endpoint*>(data);
+        e->batch_meta.clear();
+        if (e->filter == nullptr) {
+            for (int32_t i = 0; i < count; ++i) {
+                e->batch_meta.push_back(meta_of(e, proofmeta, i));
+            }
+            e->exported += e->ring->push_batch(e->position.id, literals, offsets, count, e->batch_meta.data());
+            return;
+        }
+        e->batch_literals.clear();
+        e->batch_offsets.assign(1, 0);
+        for (int32_t i = 0; i < count; ++i) {
+            int32_t const* clause = literals + offsets[i];
+            int32_t len = offsets[i + 1] - offsets[i];
+            ipasir2_clause_meta const* meta = meta_of(e, proofmeta, i);
+            if (!e->ring->accepts(len, meta)) {
+                continue;
+            }
+            if (!e->filter->insert(clause, len)) {
+                ++e->filtered;
+                continue;
+            }
+            e->batch_literals.insert(e->batch_literals.end(), clause, clause + len);
+            e->batch_offsets.push_back(e->batch_literals.size());
+            e->batch_meta.push_back(meta);
+        }
+        e->exported += e->ring->push_batch(e->position.id, e->batch_literals.data(), e->batch_offsets.data(),
+            e->batch_offsets.size() - 1, e->batch_meta.data());
+    }
+
+    // imports at most one clause per call, as specified for ipasir2_set_import()
+    static void import_callback(void* data) {
+        endpoint* e = static_cast<endpoint*>(data);
+        int32_t len;
+        ipasir2_clause_meta* meta;
+        if (e->ring->pop(e->position, e->buffer.data(), len, meta)) {
+            ipasir2_add(e->solver, e->buffer.data(), len, 1, e->clause_meta ? meta : nullptr);
+            ++e->imported;
+        }
+    }
+
+private:
+    // metadata of the i-th clause of an exported batch, or nullptr if the solver does not pass it
+    static ipasir2_clause_meta const* meta_of(endpoint const* e, void* const* proofmeta, int32_t i) {
+        if (!e->clause_meta || proofmeta == nullptr) {
+            return nullptr;
+        }
+        return static_cast<ipasir2_clause_meta const*>(proofmeta[i]);
+    }
+
+    // copies the clause into the slot of position pos, which the caller reserved by advancing the head
+    bool store(uint64_t pos, int32_t producer, int32_t const* clause, int32_t len, ipasir2_clause_meta const* meta) {
+        slot& s = m_slots[pos & m_mask];
+        uint64_t writing = 2 * pos + 1;
+        uint64_t seq = s.seq.load(std::memory_order_acquire);
+        while (true) {
+            if (seq >= writing) {
+                return false;
+            }
+            if (seq & 1) {
+                // an older clause is still being copied into this slot, readers skip pos once it is marked
+                uint64_t dropped = s.dropped.load(std::memory_order_relaxed);
+                while (dropped <= pos
+                    && !s.dropped.compare_exchange_weak(dropped, pos + 1, std::memory_order_release)) {
+                }
+                return false;
+            }
+            if (s.seq.compare_exchange_weak(seq, writing, std::memory_order_acquire)) {
+                break;
+            }
+        }
+        // orders the odd sequence number before the payload, so readers detect torn slots
+        std::atomic_thread_fence(std::memory_order_release);
+        std::atomic<int32_t>* lits = &m_slab[(pos & m_mask) * m_max_length];
+        for (int32_t i = 0; i < len; ++i) {
+            lits[i].store(clause[i], std::memory_order_relaxed);
+        }
+        s.len.store(len, std::memory_order_relaxed);
+        s.producer.store(producer, std::memory_order_relaxed);
+        s.has_meta.store(meta != nullptr, std::memory_order_relaxed);
+        s.id.store(meta != nullptr ? meta->id : 0, std::memory_order_relaxed);
+        s.lbd.store(meta != nullptr ? meta->lbd : 0, std::memory_order_relaxed);
+        s.activity.store(meta != nullptr ? meta->activity : 0, std::memory_order_relaxed);
+        s.redundancy.store(meta != nullptr ? meta->redundancy : IPASIR2_R_UNKNOWN, std::memory_order_relaxed);
+        s.seq.store(writing + 1, std::memory_order_release);
+        return true;
+    }
+
+    struct alignas(64) slot {
+        std::atomic<uint64_t> seq { 0 };
+        std::atomic<uint64_t> dropped { 0 };    // 1 + the last position dropped while the slot was odd
+        std::atomic<int32_t> len { 0 };
+        std::atomic<int32_t> producer { -1 };
+        std::atomic<bool> has_meta { false };
+        std::atomic<int32_t> lbd { 0 };
+        std::atomic<int32_t> redundancy { 0 };
+        std::atomic<float> activity { 0 };
+        std::atomic<uint64_t> id { 0 };
+    };
+
+    int32_t m_max_length;
+    int32_t m_max_lbd = -1;
+    uint64_t m_mask;
+    std::unique_ptr<slot[]> m_slots;
+    std::unique_ptr<std::atomic<int32_t>[]> m_slab;
+    alignas(64) std::atomic<uint64_t> m_head { 0 };
+};
+
+#endif // IPASIR2_CLAUSE_RING_H
@@ -0,0 +1,439 @@
+/**
+ * MIT License
+ *
+ * Cube-and-conquer: splits a DIMACS CNF formula into cubes and solves them in parallel.
+ *
+ * Cube phase: a single instance probes literals under the cube built so far with short solve calls,
+ * bounded by ipasir.limits.conflicts and ipasir.limits.decisions (or by a budget of terminate polls
+ * if the backend supports neither). Candidates are the variables occurring most often. A literal
+ * whose probe is refuted implies its negation, which is added to the cube. If both literals of a
+ * candidate are refuted, the whole cube is refuted and its negation is added as a clause. Otherwise
+ * the cube is split on the most frequent candidate whose probes both ran into the limit, until the
+ * given depth is reached.
+ *
+ * Conquer phase: N worker threads each load the formula into their own instance and solve the cubes
+ * as assumptions. Each worker takes cubes from the back of its own queue and steals from the front of
+ * the others' when it runs out. When a cube is refuted, the negation of its failed assumptions is
+ * shared with the other workers, which add it before their next cube. The first satisfiable cube
+ * stops all workers through ipasir2_set_terminate().
+ *
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ipasir2.h"
+#include "ipasir2_util.h"
+#include "dimacs.h"
+
+
+typedef std::vector<int32_t> cube;
+
+struct formula {
+    std::vector<int32_t> literals;
+    std::vector<int32_t> offsets { 0 };
+    int32_t max_var = 0;
+};
+
+/**
+ * Probing instance of the cube phase
+ */
+class splitter {
+public:
+    struct config {
+        int32_t depth = 6;
+        int32_t candidates = 8;
+        int64_t conflicts = 100;
+    };
+
+    splitter(formula const& f, config const& cfg) : m_config(cfg) {
+        ipasir2_errorcode err = ipasir2_init(&m_solver);
+        if (err) {
+            throw std::runtime_error("ipasir2_init() returned " + ipasir2_errorcode_to_string(err));
+        }
+        ipasir2_option_index options(m_solver);
+        ipasir2_option const* conflicts = options.find(IPASIR2_O_LIMITS_CONFLICTS);
+        ipasir2_option const* decisions = options.find(IPASIR2_O_LIMITS_DECISIONS);
+        m_limited = conflicts != nullptr && ipasir2_set_option(m_solver, conflicts, cfg.conflicts, 0) == IPASIR2_E_OK;
+        // a decision limit keeps probes short on instances where few decisions lead to conflicts
+        if (decisions != nullptr && ipasir2_set_option(m_solver, decisions, cfg.conflicts * 10, 0) == IPASIR2_E_OK) {
+            m_limited = true;
+        }
+        if (!m_limited) {
+            ipasir2_set_terminate(m_solver, this, [](void* data) {
+                splitter* s = static_cast<splitter*>(data);
+                return static_cast<int>(++s->m_polls > s->m_config.conflicts);
+            });
+        }
+        err = ipasir2_add_formula(m_solver, f.literals.data(), f.offsets.data(), f.offsets.size() - 1);
+        if (err) {
+            throw std::runtime_error("ipasir2_add_clauses() returned " + ipasir2_errorcode_to_string(err));
+        }
+
+        // candidates are the variables with the most occurrences
+        std::vector<int32_t> occurrences(f.max_var + 1, 0);
+        for (int32_t lit : f.literals) {
+            ++occurrences[std::abs(lit)];
+        }
+        for (int32_t var = 1; var <= f.max_var; ++var) {
+            if (occurrences[var] > 0) {
+                m_order.push_back(var);
+            }
+        }
+        std::stable_sort(m_order.begin(), m_order.end(), [&](int32_t a, int32_t b) { return occurrences[a] > occurrences[b]; });
+    }
+
+    ~splitter() {
+        ipasir2_release(m_solver);
+    }
+
+    /**
+     * Splits the formula into cubes. Returns RESULT_SAT if a probe finds a model, which is then
+     * available from solver(), RESULT_UNSAT if all cubes are refuted, and 0 otherwise.
+     */
+    int split() {
+        m_result = 0;
+        split({}, 0);
+        if (m_result == 0 && m_cubes.empty()) {
+            m_result = RESULT_UNSAT;
+        }
+        return m_result;
+    }
+
+    std::vector<cube> const& cubes() const { return m_cubes; }
+    std::vector<cube> const& refuted() const { return m_refuted; }
+    uint64_t probes() const { return m_probes; }
+    void* solver() const { return m_solver; }
+
+private:
+    int probe(cube const& c) {
+        ++m_probes;
+        m_polls = 0;
+        int result = 0;
+        ipasir2_errorcode err = ipasir2_solve(m_solver, &result, c.data(), c.size());
+        if (err) {
+            throw std::runtime_error("ipasir2_solve() returned " + ipasir2_errorcode_to_string(err));
+        }
+        return result;
+    }
+
+    void refute(cube const& c) {
+        cube clause;
+        for (int32_t lit : c) {
+            clause.push_back(-lit);
+        }
+        if (!clause.empty()) {
+            ipasir2_add(m_solver, clause.data(), clause.size(), 0, nullptr);
+        }
+        m_refuted.push_back(clause);
+    }
+
+    void split(cube c, int32_t depth) {
+        if (m_result == RESULT_SAT) {
+            return;
+        }
+        int result = probe(c);
+        if (result == RESULT_SAT) {
+            m_result = result;
+            return;
+        }
+        if (result == RESULT_UNSAT) {
+            refute(c);
+            return;
+        }
+        if (depth == m_config.depth) {
+            m_cubes.push_back(c);
+            return;
+        }
+
+        int32_t branch = 0;
+        int32_t probed = 0;
+        for (size_t i = 0; i < m_order.size() && probed < m_config.candidates; ++i) {
+            int32_t var = m_order[i];
+            if (std::find_if(c.begin(), c.end(), [var](int32_t lit) { return std::abs(lit) == var; }) != c.end()) {
+                continue;
+            }
+            ++probed;
+            int results[2];
+            for (int polarity = 0; polarity < 2; ++polarity) {
+                c.push_back(polarity ? -var : var);
+                results[polarity] = probe(c);
+                c.pop_back();
+                if (results[polarity] == RESULT_SAT) {
+                    m_result = RESULT_SAT;
+                    return;
+                }
+            }
+            if (results[0] == RESULT_UNSAT && results[1] == RESULT_UNSAT) {
+                refute(c);
+                return;
+            }
+            if (results[0] == RESULT_UNSAT || results[1] == RESULT_UNSAT) {
+                // failed literal: the cube implies the other polarity
+                c.push_back(results[0] == RESULT_UNSAT ? -var : var);
+            }
+            else if (branch == 0) {
+                branch = var;
+            }
+        }
+        if (branch == 0) {
+            m_cubes.push_back(c);
+            return;
+        }
+        c.push_back(branch);
+        split(c, depth + 1);
+        c.back() = -branch;
+        split(c, depth + 1);
+    }
+
+    config m_config;
+    void* m_solver = nullptr;
+    bool m_limited = false;
+    int64_t m_polls = 0;
+    uint64_t m_probes = 0;
+    int m_result = 0;
+    std::vector<int32_t> m_order;
+    std::vector<cube> m_cubes;
+    std::vector<cube> m_refuted;
+};
+
+
+// Clauses refuting cubes, shared between the workers
+class clause_store {
+public:
+    void add(std::vector<int32_t> clause) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_clauses.push_back(std::move(clause));
+    }
+
+    // adds the clauses from index \p next on to the solver, returns the new index
+    size_t import(void* solver, size_t next) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (; next < m_clauses.size(); ++next) {
+            ipasir2_add(solver, m_clauses[next].data(), m_clauses[next].size(), 0, nullptr);
+        }
+        return next;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<std::vector<int32_t>> m_clauses;
+};
+
+struct work_queue {
+    std::mutex mutex;
+    std::deque<cube> cubes;
+};
+
+struct worker {
+    int32_t id;
+    void* solver = nullptr;
+    int result = 0;
+    ipasir2_errorcode err = IPASIR2_E_OK;
+    uint64_t solved = 0;
+    uint64_t unknown = 0;
+    uint64_t stolen = 0;
+    size_t imported = 0;
+};
+
+// takes a cube from the back of the own queue, or steals one from the front of another queue
+bool next_cube(std::vector<work_queue>& queues, worker& w, cube& c) {
+    {
+        work_queue& own = queues[w.id];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.cubes.empty()) {
+            c = std::move(own.cubes.back());
+            own.cubes.pop_back();
+            return true;
+        }
+    }
+    for (size_t i = 1; i < queues.size(); ++i) {
+        work_queue& other = queues[(w.id + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.cubes.empty()) {
+            c = std::move(other.cubes.front());
+            other.cubes.pop_front();
+            ++w.stolen;
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char** argv) {
+    int32_t threads = std::thread::hardware_concurrency();
+    splitter::config cfg;
+    char const* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-t" && i + 1 < argc) {
+            threads = std::stoi(argv[++i]);
+        }
+        else if (arg == "-d" && i + 1 < argc) {
+            cfg.depth = std::stoi(argv[++i]);
+        }
+        else if (arg == "-k" && i + 1 < argc) {
+            cfg.candidates = std::stoi(argv[++i]);
+        }
+        else if (arg == "-c" && i + 1 < argc) {
+            cfg.conflicts = std::stoll(argv[++i]);
+        }
+        else {
+            path = argv[i];
+        }
+    }
+    if (path == nullptr) {
+        std::cerr << "Usage: " << argv[0] << " [-t threads] [-d cube depth] [-k candidates per cube] [-c conflicts per probe] <file.cnf>" << std::endl;
+        return 1;
+    }
+    threads = std::max(threads, 1);
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "c solver: " << signature << ", " << threads << " workers" << std::endl;
+
+    formula f;
+    try {
+        dimacs_reader reader(path);
+        while (reader.next() == dimacs_reader::CLAUSES) {
+            f.literals.insert(f.literals.end(), reader.literals(), reader.literals() + reader.offsets()[reader.count()]);
+            for (int32_t i = 1; i <= reader.count(); ++i) {
+                f.offsets.push_back(f.offsets.back() + reader.offsets()[i] - reader.offsets()[i - 1]);
+            }
+        }
+        f.max_var = reader.max_variable();
+    }
+    catch (std::runtime_error const& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<splitter> cubes;
+    int result = 0;
+    try {
+        cubes.reset(new splitter(f, cfg));
+        result = cubes->split();
+    }
+    catch (std::runtime_error const& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    double cube_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "c cube phase: " << cubes->cubes().size() << " cubes, " << cubes->refuted().size() << " refuted, ";
+    std::cout << cubes->probes() << " probes, " << cube_seconds << " s" << std::endl;
+
+    if (result == RESULT_SAT) {
+        puts("s SATISFIABLE");
+        ipasir2_print_model(cubes->solver(), f.max_var);
+        return result;
+    }
+    if (result == RESULT_UNSAT) {
+        puts("s UNSATISFIABLE");
+        return result;
+    }
+
+    clause_store shared;
+    for (cube const& clause : cubes->refuted()) {
+        shared.add(clause);
+    }
+    std::vector<work_queue> queues(threads);
+    for (size_t i = 0; i < cubes->cubes().size(); ++i) {
+        queues[i % threads].cubes.push_back(cubes->cubes()[i]);
+    }
+
+    // set to the id of the worker which found a model or refuted the formula
+    std::atomic<int32_t> winner { -1 };
+    std::vector<worker> workers(threads);
+    std::vector<std::thread> pool;
+    for (int32_t id = 0; id < threads; ++id) {
+        pool.emplace_back([&, id]() {
+            worker& w = workers[id];
+            w.id = id;
+            w.err = ipasir2_init(&w.solver);
+            if (w.err) return;
+            w.err = ipasir2_add_formula(w.solver, f.literals.data(), f.offsets.data(), f.offsets.size() - 1);
+            if (w.err) return;
+            ipasir2_set_terminate(w.solver, &winner, [](void* data) {
+                return static_cast<int>(static_cast<std::atomic<int32_t>*>(data)->load(std::memory_order_relaxed) >= 0);
+            });
+            cube c;
+            std::vector<int32_t> core;
+            while (winner.load(std::memory_order_relaxed) < 0 && next_cube(queues, w, c)) {
+                w.imported = shared.import(w.solver, w.imported);
+                w.err = ipasir2_solve(w.solver, &w.result, c.data(), c.size());
+                if (w.err) return;
+                ++w.solved;
+                if (w.result == RESULT_SAT) {
+                    int32_t none = -1;
+                    winner.compare_exchange_strong(none, id);
+                    return;
+                }
+                if (w.result != RESULT_UNSAT) {
+                    ++w.unknown;
+                    continue;
+                }
+                w.err = ipasir2_core(w.solver, c.data(), c.size(), core);
+                if (w.err) return;
+                for (int32_t& lit : core) {
+                    lit = -lit;
+                }
+                if (core.empty()) {
+                    // refuted without assumptions: the formula is unsatisfiable
+                    int32_t none = -1;
+                    winner.compare_exchange_strong(none, id);
+                    return;
+                }
+                shared.add(core);
+            }
+        });
+    }
+    for (std::thread& t : pool) {
+        t.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    bool complete = true;
+    for (worker const& w : workers) {
+        std::cout << "c worker " << w.id << ": " << w.solved << " cubes, " << w.stolen << " stolen, " << w.imported << " clauses imported";
+        if (w.err) {
+            std::cout << ", error " << w.err;
+            complete = false;
+        }
+        else if (w.unknown > 0) {
+            complete = false;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "c total time: " << seconds << " s" << std::endl;
+
+    if (winner >= 0 && workers[winner].result == RESULT_SAT) {
+        puts("s SATISFIABLE");
+        ipasir2_print_model(workers[winner].solver, f.max_var);
+        result = RESULT_SAT;
+    }
+    else if (winner >= 0 || complete) {
+        puts("s UNSATISFIABLE");
+        result = RESULT_UNSAT;
+    }
+    else {
+        puts("s UNKNOWN");
+    }
+
+    for (worker& w : workers) {
+        if (w.solver != nullptr) {
+            ipasir2_release(w.solver);
+        }
+    }
+    return result;
+}
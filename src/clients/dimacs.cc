@@ -0,0 +1,238 @@
+/**
+ * MIT License
+ *
+ * Streaming reader for DIMACS CNF and incremental iCNF files.
+ *
+ */
+
+#include "dimacs.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ && (defined(__GNUC__) || defined(__clang__))
+#define DIMACS_SWAR 1
+
+// Eight-byte SWAR (SIMD within a register) helpers for scanning digit runs without a branch per character.
+// Words are loaded in little-endian order, i.e., the first character is in the lowest byte.
+
+constexpr uint64_t ones = 0x0101010101010101ULL;
+
+// Sets the high bit of each byte in w which is not an ASCII digit
+inline uint64_t non_digit_mask(uint64_t w) {
+    uint64_t x = w ^ (ones * '0');
+    return (((x & (ones * 0x7F)) + ones * 0x76) | x) & (ones * 0x80);
+}
+
+// Converts the n (1 <= n <= 8) ASCII digits in the lowest bytes of w to an integer
+inline uint32_t digits_to_int(uint64_t w, int n) {
+    w <<= 8 * (8 - n);
+    w = ((w & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+    w = ((w & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+    return static_cast<uint32_t>(((w & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32);
+}
+#endif
+
+inline bool is_digit(char c) {
+    return static_cast<unsigned>(c - '0') < 10;
+}
+
+inline bool is_space(char c) {
+    return static_cast<unsigned char>(c) <= ' ';
+}
+
+}
+
+
+dimacs_reader::dimacs_reader(std::string const& path, int32_t batch_size) : m_batch_size(batch_size) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open " + path + ": " + strerror(errno));
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw std::runtime_error("cannot stat " + path + ": " + strerror(errno));
+    }
+
+    m_size = st.st_size;
+    if (m_size > 0) {
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("cannot map " + path + ": " + strerror(errno));
+        }
+        madvise(data, m_size, MADV_SEQUENTIAL);
+        m_begin = static_cast<char const*>(data);
+    }
+    close(fd);
+
+    m_end = m_begin + m_size;
+    m_pos = m_begin;
+    m_offsets.reserve(batch_size + 1);
+    m_literals.reserve(batch_size * 4);
+}
+
+dimacs_reader::~dimacs_reader() {
+    if (m_size > 0) {
+        munmap(const_cast<char*>(m_begin), m_size);
+    }
+}
+
+dimacs_reader::event dimacs_reader::next() {
+    m_literals.clear();
+    m_offsets.clear();
+    m_offsets.push_back(0);
+    m_assumptions.clear();
+
+    while (true) {
+        while (m_pos < m_end && is_space(*m_pos)) {
+            ++m_pos;
+        }
+        if (m_pos == m_end) {
+            break;
+        }
+
+        char c = *m_pos;
+        if (c == '-' || is_digit(c)) {
+            int32_t lit = parse_literal();
+            if (lit != 0) {
+                m_literals.push_back(lit);
+                m_max_var = std::max(m_max_var, std::abs(lit));
+            }
+            else {
+                m_offsets.push_back(m_literals.size());
+                if (count() == m_batch_size) {
+                    return CLAUSES;
+                }
+            }
+        }
+        else if (c == 'c') {
+            skip_line();
+        }
+        else if (c == 'p') {
+            parse_header();
+        }
+        else if (c == 'a') {
+            if (static_cast<size_t>(m_offsets.back()) != m_literals.size()) {
+                fail("unterminated clause before assumptions");
+            }
+            if (count() > 0) {
+                // deliver the pending clauses first, the assumptions are parsed by the next call
+                return CLAUSES;
+            }
+            ++m_pos;
+            while (true) {
+                while (m_pos < m_end && is_space(*m_pos)) {
+                    ++m_pos;
+                }
+                if (m_pos == m_end) {
+                    fail("unterminated assumptions");
+                }
+                int32_t lit = parse_literal();
+                if (lit == 0) {
+                    break;
+                }
+                m_assumptions.push_back(lit);
+                m_max_var = std::max(m_max_var, std::abs(lit));
+            }
+            return ASSUMPTIONS;
+        }
+        else if (c == '%') {
+            // SATLIB files end with "%\n0\n"
+            m_pos = m_end;
+        }
+        else {
+            fail("unexpected character");
+        }
+    }
+
+    // tolerate a missing zero after the last clause
+    if (static_cast<size_t>(m_offsets.back()) != m_literals.size()) {
+        m_offsets.push_back(m_literals.size());
+    }
+    return count() > 0 ? CLAUSES : END;
+}
+
+void dimacs_reader::skip_line() {
+    char const* eol = static_cast<char const*>(memchr(m_pos, '\n', m_end - m_pos));
+    m_pos = eol != nullptr ? eol + 1 : m_end;
+}
+
+void dimacs_reader::parse_header() {
+    char const* eol = static_cast<char const*>(memchr(m_pos, '\n', m_end - m_pos));
+    std::string line(m_pos, eol != nullptr ? eol : m_end);
+    long long vars = 0;
+    long long clauses = 0;
+    if (line.compare(0, 8, "p inccnf") == 0) {
+        m_incremental = true;
+    }
+    else if (sscanf(line.c_str(), "p cnf %lld %lld", &vars, &clauses) == 2) {
+        if (vars < 0 || vars > std::numeric_limits<int32_t>::max()) {
+            fail("invalid number of variables");
+        }
+        m_max_var = std::max(m_max_var, static_cast<int32_t>(vars));
+    }
+    else {
+        fail("invalid header");
+    }
+    skip_line();
+}
+
+int32_t dimacs_reader::parse_literal() {
+    bool negative = *m_pos == '-';
+    m_pos += negative;
+    char const* start = m_pos;
+    uint64_t value = 0;
+    bool done = false;
+
+#ifdef DIMACS_SWAR
+    if (m_end - m_pos >= 8) {
+        uint64_t word;
+        memcpy(&word, m_pos, 8);
+        uint64_t mask = non_digit_mask(word);
+        int n = mask != 0 ? __builtin_ctzll(mask) >> 3 : 8;
+        if (n > 0) {
+            value = digits_to_int(word, n);
+            m_pos += n;
+        }
+        done = n < 8;
+    }
+#endif
+
+    if (!done) {
+        // slow path near the end of the file and for literals with more than eight digits
+        while (m_pos < m_end && is_digit(*m_pos) && value <= std::numeric_limits<int32_t>::max()) {
+            value = value * 10 + (*m_pos - '0');
+            ++m_pos;
+        }
+    }
+
+    if (m_pos == start) {
+        fail("expected literal");
+    }
+    if (value > static_cast<uint64_t>(std::numeric_limits<int32_t>::max())) {
+        fail("literal out of range");
+    }
+    int32_t lit = static_cast<int32_t>(value);
+    return negative ? -lit : lit;
+}
+
+void dimacs_reader::fail(char const* message) const {
+    long line = 1 + std::count(m_begin, m_pos, '\n');
+    throw std::runtime_error("parse error in line " + std::to_string(line) + ": " + message);
+}
@@ -0,0 +1,82 @@
+/**
+ * MIT License
+ *
+ * Streaming reader for DIMACS CNF and incremental iCNF files.
+ *
+ * The file is memory-mapped and parsed in place. Clauses are delivered in batches
+ * using the CSR layout of ipasir2_add_clauses(), so that clients can hand each batch
+ * to the solver in one call without copying individual clauses.
+ *
+ * In iCNF files ("p inccnf"), lines of the form "a <lits> 0" request a solve call
+ * under the given assumptions. The reader stops at each such line and reports it
+ * after all preceding clauses have been delivered.
+ *
+ */
+
+#ifndef IPASIR2_DIMACS_H
+#define IPASIR2_DIMACS_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+class dimacs_reader {
+public:
+    enum event {
+        END = 0,        // end of file, no more clauses
+        CLAUSES,        // a batch of clauses is available via literals(), offsets() and count()
+        ASSUMPTIONS     // an iCNF assumption line is available via assumptions()
+    };
+
+    /**
+     * Maps the given file into memory.
+     * Throws std::runtime_error if the file cannot be opened or mapped.
+     * At most \p batch_size clauses are delivered per CLAUSES event.
+     */
+    explicit dimacs_reader(std::string const& path, int32_t batch_size = 1 << 16);
+    ~dimacs_reader();
+
+    dimacs_reader(dimacs_reader const&) = delete;
+    dimacs_reader& operator=(dimacs_reader const&) = delete;
+
+    /**
+     * Parses up to the next batch boundary or assumption line.
+     * Throws std::runtime_error on malformed input.
+     * The data returned by the accessors below is valid until the next call.
+     */
+    event next();
+
+    int32_t const* literals() const { return m_literals.data(); }
+    int32_t const* offsets() const { return m_offsets.data(); }
+    int32_t count() const { return static_cast<int32_t>(m_offsets.size()) - 1; }
+
+    std::vector<int32_t> const& assumptions() const { return m_assumptions; }
+
+    // true if the header is "p inccnf"
+    bool incremental() const { return m_incremental; }
+
+    // the larger of the variable count from the header and the largest variable seen so far
+    int32_t max_variable() const { return m_max_var; }
+
+private:
+    void skip_line();
+    void parse_header();
+    int32_t parse_literal();
+    [[noreturn]] void fail(char const* message) const;
+
+    char const* m_begin = nullptr;
+    char const* m_end = nullptr;
+    char const* m_pos = nullptr;
+    size_t m_size = 0;
+
+    int32_t m_batch_size;
+    bool m_incremental = false;
+    int32_t m_max_var = 0;
+
+    std::vector<int32_t> m_literals;
+    std::vector<int32_t> m_offsets;
+    std::vector<int32_t> m_assumptions;
+};
+
+#endif // IPASIR2_DIMACS_H
@@ -0,0 +1,152 @@
+/**
+ * MIT License
+ *
+ * Helpers shared by the benchmark clients: formula generators and latency statistics.
+ *
+ */
+
+#ifndef IPASIR2_BENCH_H
+#define IPASIR2_BENCH_H
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+
+/**
+ * Formula in the CSR layout of ipasir2_add_clauses()
+ */
+struct csr_formula {
+    std::vector<int32_t> literals;
+    std::vector<int32_t> offsets { 0 };
+    int32_t variables = 0;
+
+    int32_t size() const {
+        return offsets.size() - 1;
+    }
+
+    void add(std::vector<int32_t> const& clause) {
+        literals.insert(literals.end(), clause.begin(), clause.end());
+        offsets.push_back(literals.size());
+    }
+};
+
+inline csr_formula random_ksat(int32_t n_clauses, int32_t n_vars, int k, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int32_t> var(1, n_vars);
+    csr_formula f;
+    f.variables = n_vars;
+    f.literals.reserve(n_clauses * k);
+    f.offsets.reserve(n_clauses + 1);
+    for (int32_t i = 0; i < n_clauses; ++i) {
+        for (int j = 0; j < k; ++j) {
+            f.literals.push_back(rng() & 1 ? var(rng) : -var(rng));
+        }
+        f.offsets.push_back(f.literals.size());
+    }
+    return f;
+}
+
+/**
+ * Unsatisfiable formula stating that n + 1 pigeons fit into n holes.
+ * Hard for resolution, useful for keeping a solver busy for a controlled amount of time.
+ */
+inline csr_formula pigeonhole(int32_t holes) {
+    csr_formula f;
+    int32_t pigeons = holes + 1;
+    auto var = [holes](int32_t p, int32_t h) { return p * holes + h + 1; };
+    f.variables = pigeons * holes;
+    for (int32_t p = 0; p < pigeons; ++p) {
+        std::vector<int32_t> clause;
+        for (int32_t h = 0; h < holes; ++h) {
+            clause.push_back(var(p, h));
+        }
+        f.add(clause);
+    }
+    for (int32_t h = 0; h < holes; ++h) {
+        for (int32_t p = 0; p < pigeons; ++p) {
+            for (int32_t q = p + 1; q < pigeons; ++q) {
+                f.add({ -var(p, h), -var(q, h) });
+            }
+        }
+    }
+    return f;
+}
+
+
+// Keeps the compiler from discarding the computation of an otherwise unused value
+template<typename T>
+inline void do_not_optimize(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+
+/**
+ * Collects per-call latencies and reports their distribution.
+ * The cost of reading the clock is calibrated once and subtracted from each sample.
+ */
+class latency_sampler {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit latency_sampler(std::string name) : m_name(std::move(name)) {
+        static double const overhead = calibrate();
+        m_overhead = overhead;
+    }
+
+    template<typename F>
+    auto measure(F call) {
+        auto start = clock::now();
+        auto result = call();
+        auto end = clock::now();
+        do_not_optimize(result);
+        add(std::chrono::duration<double, std::nano>(end - start).count() - m_overhead);
+        return result;
+    }
+
+    void add(double ns) {
+        m_samples.push_back(std::max(ns, 0.0));
+    }
+
+    double percentile(double p) {
+        if (m_samples.empty()) return 0;
+        size_t k = std::min(m_samples.size() - 1, static_cast<size_t>(p * m_samples.size()));
+        std::nth_element(m_samples.begin(), m_samples.begin() + k, m_samples.end());
+        return m_samples[k];
+    }
+
+    double mean() const {
+        double sum = 0;
+        for (double s : m_samples) sum += s;
+        return m_samples.empty() ? 0 : sum / m_samples.size();
+    }
+
+    void report() {
+        printf("%-32s %10zu %12.1f %12.1f %12.1f\n", m_name.c_str(), m_samples.size(), percentile(0.5), percentile(0.99), mean());
+    }
+
+    static void report_header() {
+        printf("%-32s %10s %12s %12s %12s\n", "function", "calls", "p50 [ns]", "p99 [ns]", "mean [ns]");
+    }
+
+private:
+    static double calibrate() {
+        std::vector<double> samples(10000);
+        for (double& s : samples) {
+            auto start = clock::now();
+            auto end = clock::now();
+            s = std::chrono::duration<double, std::nano>(end - start).count();
+        }
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        return samples[samples.size() / 2];
+    }
+
+    std::string m_name;
+    double m_overhead;
+    std::vector<double> m_samples;
+};
+
+#endif // IPASIR2_BENCH_H
@@ -10,9 +10,13 @@
 
 #include <stdio.h>
 #include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include "ipasir2.h"
+#include "ipasir2_optional.h"
 
 #define RESULT_UNKNOWN 0
 #define RESULT_SAT 10
@@ -23,13 +27,111 @@ typedef std::initializer_list<clause> cnf;
 
 ipasir2_errorcode ipasir2_add_clause(void* solver, clause c) {
     std::vector<int32_t> cl(c.begin(), c.end());
-    return ipasir2_add(solver, cl.data(), cl.size(), 0);
+    return ipasir2_add(solver, cl.data(), cl.size(), 0, nullptr);
+}
+
+/**
+ * Adds the clauses given in CSR layout (see ipasir2_add_clauses()) in a single call.
+ * Falls back to one ipasir2_add() call per clause if the solver does not support bulk addition.
+ */
+ipasir2_errorcode ipasir2_add_formula(void* solver, int32_t const* literals, int32_t const* offsets, int32_t count) {
+    ipasir2_errorcode ret = IPASIR2_E_UNSUPPORTED;
+    if (ipasir2_add_clauses != nullptr) {
+        ret = ipasir2_add_clauses(solver, literals, offsets, count, 0, nullptr);
+    }
+    if (ret != IPASIR2_E_UNSUPPORTED) {
+        return ret;
+    }
+    for (int32_t i = 0; i < count; ++i) {
+        ret = ipasir2_add(solver, literals + offsets[i], offsets[i+1] - offsets[i], 0, nullptr);
+        if (ret) {
+            return ret;
+        }
+    }
+    return IPASIR2_E_OK;
 }
 
 ipasir2_errorcode ipasir2_add_formula(void* solver, cnf c) {
-    ipasir2_errorcode ret;
+    std::vector<int32_t> literals;
+    std::vector<int32_t> offsets { 0 };
+    offsets.reserve(c.size() + 1);
     for (auto cl : c) {
-        ret = ipasir2_add_clause(solver, cl);
+        literals.insert(literals.end(), cl.begin(), cl.end());
+        offsets.push_back(literals.size());
+    }
+    return ipasir2_add_formula(solver, literals.data(), offsets.data(), c.size());
+}
+
+/**
+ * Writes the values of the variables first to first + count - 1 to result (see ipasir2_values()).
+ * Falls back to one ipasir2_value() call per variable if the solver does not support vectorized extraction.
+ */
+ipasir2_errorcode ipasir2_model(void* solver, int32_t first, int32_t count, int8_t* result) {
+    ipasir2_errorcode ret = IPASIR2_E_UNSUPPORTED;
+    if (ipasir2_values != nullptr) {
+        ret = ipasir2_values(solver, first, count, result);
+    }
+    if (ret != IPASIR2_E_UNSUPPORTED) {
+        return ret;
+    }
+    for (int32_t i = 0; i < count; ++i) {
+        int32_t value;
+        ret = ipasir2_value(solver, first + i, &value);
+        if (ret) {
+            return ret;
+        }
+        result[i] = value > 0 ? 1 : (value < 0 ? -1 : 0);
+    }
+    return IPASIR2_E_OK;
+}
+
+/**
+ * Replaces the content of core with the failed literals among the given assumptions (see ipasir2_failed_core()).
+ * Falls back to one ipasir2_failed() call per assumption if the solver does not support core retrieval.
+ */
+ipasir2_errorcode ipasir2_core(void* solver, int32_t const* assumptions, int32_t len, std::vector<int32_t>& core) {
+    int32_t size = 0;
+    core.clear();
+    ipasir2_errorcode ret = IPASIR2_E_UNSUPPORTED;
+    if (ipasir2_failed_core != nullptr) {
+        ret = ipasir2_failed_core(solver, nullptr, 0, &size);
+    }
+    if (ret == IPASIR2_E_OK) {
+        core.resize(size);
+        return ipasir2_failed_core(solver, core.data(), size, &size);
+    }
+    if (ret != IPASIR2_E_UNSUPPORTED) {
+        return ret;
+    }
+    for (int32_t i = 0; i < len; ++i) {
+        int failed;
+        ret = ipasir2_failed(solver, assumptions[i], &failed);
+        if (ret) {
+            return ret;
+        }
+        if (failed) {
+            core.push_back(assumptions[i]);
+        }
+    }
+    return IPASIR2_E_OK;
+}
+
+/**
+ * Sets an indexed option for many indices in one call (see ipasir2_set_option_array()).
+ * Falls back to one ipasir2_set_option() call per index if the solver does not support bulk option setting.
+ * Note that the fallback cannot guarantee that no value is set if one of the values is invalid.
+ */
+ipasir2_errorcode ipasir2_set_option_values(void* solver, ipasir2_option const* handle, int64_t const* values,
+    int64_t const* indices, int64_t first, int32_t count) {
+    ipasir2_errorcode ret = IPASIR2_E_UNSUPPORTED;
+    if (ipasir2_set_option_array != nullptr) {
+        ret = ipasir2_set_option_array(solver, handle, values, indices, first, count);
+    }
+    if (ret != IPASIR2_E_UNSUPPORTED) {
+        return ret;
+    }
+    for (int32_t i = 0; i < count; ++i) {
+        ret = ipasir2_set_option(solver, handle, values[i], indices != nullptr ? indices[i] : first + i);
         if (ret) {
             return ret;
         }
@@ -37,6 +139,90 @@ ipasir2_errorcode ipasir2_add_formula(void* solver, cnf c) {
     return IPASIR2_E_OK;
 }
 
+/**
+ * Standard options from OPTIONS.md, in the order of ipasir2_standard_option_names
+ */
+enum ipasir2_standard_option {
+    IPASIR2_O_LIMITS_CONFLICTS = 0,
+    IPASIR2_O_LIMITS_DECISIONS,
+    IPASIR2_O_YOLO,
+    IPASIR2_O_VARIABLES_PHASE_INITIAL,
+    IPASIR2_O_VARIABLES_SCORE_INITIAL,
+    IPASIR2_O_VARIABLES_FROZEN,
+    IPASIR2_O_ASSUMPTIONS_PROPAGATE,
+    IPASIR2_O_ASSUMPTIONS_FIXED,
+    IPASIR2_O_ASSUMPTIONS_REUSE_TRAIL,
+    IPASIR2_O_PROOFMETA_CLAUSE,
+    IPASIR2_O_EXPORT_MAX_LBD,
+    IPASIR2_O_STANDARD_COUNT
+};
+
+constexpr char const* ipasir2_standard_option_names[IPASIR2_O_STANDARD_COUNT] = {
+    "ipasir.limits.conflicts",
+    "ipasir.limits.decisions",
+    "ipasir.yolo",
+    "ipasir.variables.phase.initial",
+    "ipasir.variables.score.initial",
+    "ipasir.variables.frozen",
+    "ipasir.assumptions.propagate",
+    "ipasir.assumptions.fixed",
+    "ipasir.assumptions.reuse_trail",
+    "ipasir.proofmeta.clause",
+    "ipasir.export.max_lbd",
+};
+
+/**
+ * Cached option handle lookup, replacing the linear search of ipasir2_get_option_handle().
+ * Build one index per solver instance: it calls ipasir2_options() once, resolves the standard
+ * options into a fixed table and hashes all option names. The option names are owned by the
+ * solver, so the index must not outlive it.
+ */
+class ipasir2_option_index {
+public:
+    ipasir2_option_index() = default;
+
+    explicit ipasir2_option_index(void* solver) {
+        ipasir2_option const* options = nullptr;
+        int count = 0;
+        if (ipasir2_options(solver, &options, &count) == IPASIR2_E_OK) {
+            build(options, count);
+        }
+    }
+
+    ipasir2_option_index(ipasir2_option const* options, int count) {
+        build(options, count);
+    }
+
+    // returns nullptr if the solver does not support the option
+    ipasir2_option const* find(std::string_view name) const {
+        auto it = m_by_name.find(name);
+        return it != m_by_name.end() ? it->second : nullptr;
+    }
+
+    ipasir2_option const* find(ipasir2_standard_option option) const {
+        return m_standard[option];
+    }
+
+    ipasir2_errorcode get(std::string_view name, ipasir2_option const** handle) const {
+        *handle = find(name);
+        return *handle != nullptr ? IPASIR2_E_OK : IPASIR2_E_UNSUPPORTED_OPTION;
+    }
+
+private:
+    void build(ipasir2_option const* options, int count) {
+        m_by_name.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            m_by_name.emplace(options[i].name, &options[i]);
+        }
+        for (int i = 0; i < IPASIR2_O_STANDARD_COUNT; ++i) {
+            m_standard[i] = find(ipasir2_standard_option_names[i]);
+        }
+    }
+
+    std::unordered_map<std::string_view, ipasir2_option const*> m_by_name;
+    ipasir2_option const* m_standard[IPASIR2_O_STANDARD_COUNT] = {};
+};
+
 std::string ipasir2_errorcode_to_string(ipasir2_errorcode err) {
     switch (err) {
         case IPASIR2_E_OK:
@@ -92,4 +278,27 @@ std::ostream& operator<<(std::ostream& os, const ipasir2_option& option) {
     return os;
 }
 
+/**
+ * Prints the model of variables 1 to max_var in DIMACS "v" lines.
+ */
+void ipasir2_print_model(void* solver, int32_t max_var) {
+    std::vector<int8_t> values(max_var);
+    ipasir2_errorcode err = ipasir2_model(solver, 1, max_var, values.data());
+    if (err) {
+        std::cout << "c ipasir2_values() returned " << err << std::endl;
+        return;
+    }
+    std::string line = "v";
+    for (int32_t var = 1; var <= max_var; ++var) {
+        line += ' ';
+        line += std::to_string(values[var - 1] < 0 ? -var : var);
+        if (line.size() > 76) {
+            puts(line.c_str());
+            line = "v";
+        }
+    }
+    line += " 0";
+    puts(line.c_str());
+}
+
 #endif // IPASIR2_UTIL_H
\ No newline at end of file
@@ -0,0 +1,84 @@
+/**
+ * MIT License
+ *
+ * Runtime loading of IPASIR-2 backends from shared libraries.
+ *
+ */
+
+#include "loader.h"
+
+#include <stdexcept>
+
+#include <dlfcn.h>
+
+
+namespace {
+
+void* open_library(std::string const& path, backend_library::isolation mode) {
+#if defined(__GLIBC__) && defined(_GNU_SOURCE)
+    if (mode == backend_library::OWN_NAMESPACE) {
+        return dlmopen(LM_ID_NEWLM, path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    }
+#endif
+    int flags = RTLD_NOW | RTLD_LOCAL;
+#ifdef RTLD_DEEPBIND
+    // the backend's calls to its own ipasir2_* functions must not bind to another backend
+    flags |= RTLD_DEEPBIND;
+#endif
+    return dlopen(path.c_str(), flags);
+}
+
+}
+
+
+backend_library::backend_library(std::string const& path, isolation mode) : m_path(path) {
+    m_handle = open_library(path, mode);
+    if (m_handle == nullptr) {
+        char const* error = dlerror();
+        throw std::runtime_error("cannot load " + path + ": " + (error != nullptr ? error : "unknown error"));
+    }
+    try {
+        resolve("ipasir2_signature", signature, true);
+        resolve("ipasir2_init", init, true);
+        resolve("ipasir2_release", release, true);
+        resolve("ipasir2_clone", clone, false);
+        resolve("ipasir2_options", options, false);
+        resolve("ipasir2_set_option", set_option, false);
+        resolve("ipasir2_set_option_array", set_option_array, false);
+        resolve("ipasir2_add", add, true);
+        resolve("ipasir2_add_clauses", add_clauses, false);
+        resolve("ipasir2_solve", solve, true);
+        resolve("ipasir2_value", value, false);
+        resolve("ipasir2_values", values, false);
+        resolve("ipasir2_failed", failed, false);
+        resolve("ipasir2_failed_core", failed_core, false);
+        resolve("ipasir2_set_terminate", set_terminate, false);
+        resolve("ipasir2_set_export", set_export, false);
+        resolve("ipasir2_set_export_batch", set_export_batch, false);
+        resolve("ipasir2_set_delete", set_delete, false);
+        resolve("ipasir2_set_import", set_import, false);
+        resolve("ipasir2_set_fixed", set_fixed, false);
+    }
+    catch (...) {
+        dlclose(m_handle);
+        throw;
+    }
+    char const* sig = nullptr;
+    m_name = signature(&sig) == IPASIR2_E_OK && sig != nullptr ? sig : path;
+}
+
+backend_library::~backend_library() {
+    dlclose(m_handle);
+}
+
+template<typename... Args>
+void backend_library::resolve(char const* symbol, ipasir2_errorcode (*&function)(Args...), bool required) {
+    function = reinterpret_cast<ipasir2_errorcode (*)(Args...)>(dlsym(m_handle, symbol));
+    if (function != nullptr) {
+        return;
+    }
+    if (required) {
+        throw std::runtime_error(m_path + " does not define " + symbol);
+    }
+    function = [](Args...) { return IPASIR2_E_UNSUPPORTED; };
+}
@@ -0,0 +1,82 @@
+/**
+ * MIT License
+ *
+ * Runtime loading of IPASIR-2 backends from shared libraries.
+ *
+ * All backends export the same ipasir2_* symbols, so an executable can link only one of them.
+ * A backend_library loads the shared library of a backend and resolves its functions into a
+ * table of function pointers, so that one process can drive several backends side by side.
+ *
+ * By default, each library is loaded into its own link-map namespace with dlmopen(), which
+ * also isolates the libraries it depends on, e.g., backends built against different versions
+ * of a common dependency or with clashing internal symbols. Where dlmopen() is not available,
+ * the library is loaded with RTLD_LOCAL and, if supported, RTLD_DEEPBIND.
+ *
+ * Namespaces are a scarce resource: glibc supports at most 16, and each one loads its own
+ * copy of libc whose static TLS is not reclaimed when the library is unloaded. Load each
+ * backend once and keep it loaded (the tunable glibc.rtld.optional_static_tls raises the limit).
+ *
+ */
+
+#ifndef IPASIR2_LOADER_H
+#define IPASIR2_LOADER_H
+
+#include <string>
+
+#include "ipasir2.h"
+
+
+class backend_library {
+public:
+    enum isolation {
+        OWN_NAMESPACE = 0,      // dlmopen(LM_ID_NEWLM, ...) where available
+        SHARED_NAMESPACE        // dlopen(..., RTLD_LOCAL)
+    };
+
+    /**
+     * Loads the shared library at \p path and resolves the IPASIR-2 functions.
+     * Throws std::runtime_error if the library cannot be loaded or lacks one of the functions
+     * signature, init, release, add and solve. Other missing functions return IPASIR2_E_UNSUPPORTED.
+     */
+    explicit backend_library(std::string const& path, isolation mode = OWN_NAMESPACE);
+    ~backend_library();
+
+    backend_library(backend_library const&) = delete;
+    backend_library& operator=(backend_library const&) = delete;
+
+    std::string const& path() const { return m_path; }
+
+    // the signature reported by the backend
+    std::string const& name() const { return m_name; }
+
+    decltype(&ipasir2_signature) signature = nullptr;
+    decltype(&ipasir2_init) init = nullptr;
+    decltype(&ipasir2_release) release = nullptr;
+    decltype(&ipasir2_clone) clone = nullptr;
+    decltype(&ipasir2_options) options = nullptr;
+    decltype(&ipasir2_set_option) set_option = nullptr;
+    decltype(&ipasir2_set_option_array) set_option_array = nullptr;
+    decltype(&ipasir2_add) add = nullptr;
+    decltype(&ipasir2_add_clauses) add_clauses = nullptr;
+    decltype(&ipasir2_solve) solve = nullptr;
+    decltype(&ipasir2_value) value = nullptr;
+    decltype(&ipasir2_values) values = nullptr;
+    decltype(&ipasir2_failed) failed = nullptr;
+    decltype(&ipasir2_failed_core) failed_core = nullptr;
+    decltype(&ipasir2_set_terminate) set_terminate = nullptr;
+    decltype(&ipasir2_set_export) set_export = nullptr;
+    decltype(&ipasir2_set_export_batch) set_export_batch = nullptr;
+    decltype(&ipasir2_set_delete) set_delete = nullptr;
+    decltype(&ipasir2_set_import) set_import = nullptr;
+    decltype(&ipasir2_set_fixed) set_fixed = nullptr;
+
+private:
+    template<typename... Args>
+    void resolve(char const* symbol, ipasir2_errorcode (*&function)(Args...), bool required);
+
+    std::string m_path;
+    std::string m_name;
+    void* m_handle = nullptr;
+};
+
+#endif // IPASIR2_LOADER_H
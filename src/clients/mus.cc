@@ -0,0 +1,223 @@
+/**
+ * MIT License
+ *
+ * Extracts a minimal unsatisfiable subset (MUS) of the clauses of a DIMACS CNF formula.
+ *
+ * Usage: mus [-t threads] [-c conflicts] [-T seconds] [-r replicate instead of clone] <file.cnf>
+ *
+ * Each clause is extended by the negation of a fresh selector variable, and the formula is solved
+ * under the assumption of all selectors. The failed selectors (ipasir2_failed()) give the initial
+ * core, which is then shrunk by deletion: a worker checks whether the current set without one clause
+ * is still unsatisfiable.
+ * - If it is, the failed selectors of that call become the new current set (clause-set refinement),
+ *   dropping the tested clause and usually many others.
+ * - If it is not, the clause is critical, i.e. part of every MUS of the current set. The model is then
+ *   rotated: flipping a variable of the critical clause which leaves exactly one other clause of the
+ *   current set falsified shows that clause to be critical as well, without a solve call.
+ *
+ * Each check is bounded by ipasir.limits.conflicts. Checks running into the limit are put back into
+ * the queue and retried with twice the budget, so hard checks do not hold up the easy ones. With
+ * several threads, the workers check different clauses at the same time on their own instances,
+ * cloned from the first one with ipasir2_clone() or replicated from the formula. A model always proves
+ * criticality for the current set, since it only shrinks. A refinement is only applied if its core is
+ * still contained in the current set, otherwise the check is repeated.
+ *
+ * With a time limit, the current core is printed once the limit is reached, even if it is not minimal.
+ * Prints "s UNSATISFIABLE" and the 1-based indices of the clauses of the MUS in "v" lines, or
+ * "s SATISFIABLE" if the formula is satisfiable.
+ *
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ipasir2.h"
+#include "ipasir2_util.h"
+#include "dimacs.h"
+#include "mus_state.h"
+
+
+void check(ipasir2_errorcode err, char const* function) {
+    if (err) {
+        throw std::runtime_error(std::string(function) + "() returned " + ipasir2_errorcode_to_string(err));
+    }
+}
+
+int main(int argc, char** argv) {
+    int32_t threads = 1;
+    int64_t conflicts = 1000;
+    double seconds_limit = -1;
+    bool replicate = false;
+    char const* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-t" && i + 1 < argc) {
+            threads = std::stoi(argv[++i]);
+        }
+        else if (arg == "-c" && i + 1 < argc) {
+            conflicts = std::stoll(argv[++i]);
+        }
+        else if (arg == "-T" && i + 1 < argc) {
+            seconds_limit = std::stod(argv[++i]);
+        }
+        else if (arg == "-r") {
+            replicate = true;
+        }
+        else {
+            path = argv[i];
+        }
+    }
+    if (path == nullptr) {
+        std::cerr << "Usage: " << argv[0] << " [-t threads] [-c conflicts per check] [-T time limit] [-r replicate instead of clone] <file.cnf>" << std::endl;
+        return 1;
+    }
+    threads = std::max(threads, 1);
+    conflicts = std::max<int64_t>(conflicts, 1);
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "c solver: " << signature << ", " << threads << " workers" << std::endl;
+
+    mus_formula f;
+    try {
+        dimacs_reader reader(path);
+        while (reader.next() == dimacs_reader::CLAUSES) {
+            f.literals.insert(f.literals.end(), reader.literals(), reader.literals() + reader.offsets()[reader.count()]);
+            for (int32_t i = 1; i <= reader.count(); ++i) {
+                f.offsets.push_back(f.offsets.back() + reader.offsets()[i] - reader.offsets()[i - 1]);
+            }
+        }
+        f.max_var = reader.max_variable();
+    }
+    catch (std::runtime_error const& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    mus_deadline limit;
+    if (seconds_limit >= 0) {
+        limit.end = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds_limit));
+    }
+
+    // clauses with selectors: the selector of clause i is max_var + 1 + i
+    mus_formula selected;
+    selected.max_var = f.max_var + f.size();
+    for (int32_t i = 0; i < f.size(); ++i) {
+        selected.literals.insert(selected.literals.end(), f.literals.begin() + f.offsets[i], f.literals.begin() + f.offsets[i + 1]);
+        selected.literals.push_back(-(f.max_var + 1 + i));
+        selected.offsets.push_back(selected.literals.size());
+    }
+
+    std::vector<mus_worker> workers(threads);
+    std::vector<int32_t> core;
+    int result = 0;
+    try {
+        mus_worker& first = workers[0];
+        check(ipasir2_init(&first.solver), "ipasir2_init");
+        check(ipasir2_add_formula(first.solver, selected.literals.data(), selected.offsets.data(), selected.size()), "ipasir2_add_clauses");
+        std::vector<int32_t> assumptions;
+        for (int32_t i = 0; i < f.size(); ++i) {
+            assumptions.push_back(f.max_var + 1 + i);
+        }
+        check(ipasir2_solve(first.solver, &result, assumptions.data(), assumptions.size()), "ipasir2_solve");
+        if (result == RESULT_UNSAT) {
+            check(ipasir2_core(first.solver, assumptions.data(), assumptions.size(), core), "ipasir2_failed");
+            for (int32_t& lit : core) {
+                lit -= f.max_var + 1;
+            }
+            std::sort(core.begin(), core.end());
+        }
+    }
+    catch (std::runtime_error const& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::vector<int32_t> mus;
+    bool minimal = true;
+    if (result == RESULT_UNSAT) {
+        std::cout << "c initial core: " << core.size() << " of " << f.size() << " clauses" << std::endl;
+
+        ipasir2_errorcode cloning = replicate || ipasir2_clone == nullptr ? IPASIR2_E_UNSUPPORTED : IPASIR2_E_OK;
+        for (int32_t id = 1; id < threads && !cloning; ++id) {
+            cloning = ipasir2_clone(workers[0].solver, &workers[id].solver);
+        }
+        std::cout << "c " << (threads == 1 ? "single instance" : cloning ? "replicated instances" : "cloned instances") << std::endl;
+
+        mus_state state(f, core, conflicts);
+        std::vector<std::thread> pool;
+        for (int32_t id = 0; id < threads; ++id) {
+            pool.emplace_back([&, id]() {
+                mus_worker& w = workers[id];
+                w.id = id;
+                if (w.solver == nullptr) {
+                    w.err = ipasir2_init(&w.solver);
+                    if (w.err) return;
+                    w.err = ipasir2_add_formula(w.solver, selected.literals.data(), selected.offsets.data(), selected.size());
+                    if (w.err) return;
+                }
+                if (seconds_limit >= 0) {
+                    ipasir2_set_terminate(w.solver, &limit, [](void* data) {
+                        return static_cast<int>(static_cast<mus_deadline*>(data)->check());
+                    });
+                }
+                w.err = mus_shrink(w, state, f, limit);
+            });
+        }
+        for (std::thread& t : pool) {
+            t.join();
+        }
+        mus = state.current();
+        minimal = state.minimal();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (mus_worker const& w : workers) {
+        if (result != RESULT_UNSAT) {
+            break;
+        }
+        std::cout << "c worker " << w.id << ": " << w.unsat << " refinements, " << w.sat << " critical, ";
+        std::cout << w.rotated << " critical by rotation, " << w.unknown << " postponed, " << w.stale << " stale";
+        if (w.err) {
+            std::cout << ", error " << ipasir2_errorcode_to_string(w.err);
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "c total time: " << seconds << " s" << std::endl;
+
+    if (result == RESULT_UNSAT) {
+        puts("s UNSATISFIABLE");
+        std::cout << "c " << (minimal ? "MUS" : "core, not minimal") << " size: " << mus.size() << std::endl;
+        std::string line = "v";
+        for (int32_t clause : mus) {
+            line += ' ';
+            line += std::to_string(clause + 1);
+            if (line.size() > 76) {
+                puts(line.c_str());
+                line = "v";
+            }
+        }
+        line += " 0";
+        puts(line.c_str());
+    }
+    else if (result == RESULT_SAT) {
+        puts("s SATISFIABLE");
+    }
+    else {
+        puts("s UNKNOWN");
+    }
+
+    for (mus_worker& w : workers) {
+        if (w.solver != nullptr) {
+            ipasir2_release(w.solver);
+        }
+    }
+    return result;
+}
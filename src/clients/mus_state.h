@@ -0,0 +1,285 @@
+/**
+ * MIT License
+ *
+ * Deletion-based MUS extraction shared by several workers, see mus.cc.
+ *
+ * mus_state holds the status of the clauses of the initial core and the queue of clauses to
+ * check. Each worker runs mus_shrink() on its own solver instance, which contains the clauses
+ * of the formula extended by the negation of their selectors (the selector of clause i is
+ * max_var + 1 + i), until all clauses are decided.
+ *
+ */
+
+#ifndef IPASIR2_MUS_STATE_H
+#define IPASIR2_MUS_STATE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "ipasir2.h"
+#include "ipasir2_util.h"
+
+
+struct mus_formula {
+    std::vector<int32_t> literals;
+    std::vector<int32_t> offsets { 0 };
+    int32_t max_var = 0;
+
+    int32_t size() const {
+        return offsets.size() - 1;
+    }
+};
+
+/**
+ * Status of the clauses of the initial core and queue of clauses to check, shared between the workers
+ */
+class mus_state {
+public:
+    enum status : uint8_t { REMOVED = 0, UNKNOWN, CRITICAL };
+
+    mus_state(mus_formula const& f, std::vector<int32_t> const& core, int64_t conflicts)
+        : m_formula(f), m_status(f.size(), REMOVED), m_budget(f.size(), conflicts), m_occurrences(2 * (f.max_var + 1)) {
+        for (int32_t clause : core) {
+            m_status[clause] = UNKNOWN;
+            m_queue.push_back(clause);
+            for (int32_t i = f.offsets[clause]; i < f.offsets[clause + 1]; ++i) {
+                m_occurrences[index(f.literals[i])].push_back(clause);
+            }
+        }
+    }
+
+    /**
+     * Takes the next clause to check and writes the selectors of the current set without it to
+     * \p assumptions. Waits while all unchecked clauses are being checked by other workers. Returns -1
+     * if all clauses are decided or \p stop is set.
+     */
+    int32_t take(std::vector<int32_t>& assumptions, int64_t& budget, std::atomic<bool> const& stop) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            while (!m_queue.empty() && m_status[m_queue.front()] != UNKNOWN) {
+                m_queue.pop_front();
+            }
+            if (!m_queue.empty() || m_checking == 0 || stop.load(std::memory_order_relaxed)) {
+                break;
+            }
+            m_changed.wait(lock);
+        }
+        if (m_queue.empty() || stop.load(std::memory_order_relaxed)) {
+            m_changed.notify_all();
+            return -1;
+        }
+        int32_t clause = m_queue.front();
+        m_queue.pop_front();
+        ++m_checking;
+        assumptions.clear();
+        for (int32_t c = 0; c < static_cast<int32_t>(m_status.size()); ++c) {
+            if (m_status[c] != REMOVED && c != clause) {
+                assumptions.push_back(selector(c));
+            }
+        }
+        budget = m_budget[clause];
+        return clause;
+    }
+
+    /**
+     * Applies the failed selectors \p core of an unsatisfiable check of \p clause as the new current set.
+     * Returns false if the core is no longer contained in the current set, then the check is repeated.
+     */
+    bool refine(int32_t clause, std::vector<int32_t> const& core) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_checking;
+        std::vector<uint8_t> in_core(m_status.size(), 0);
+        for (int32_t lit : core) {
+            int32_t c = lit - m_formula.max_var - 1;
+            if (m_status[c] == REMOVED) {
+                m_queue.push_front(clause);
+                m_changed.notify_all();
+                return false;
+            }
+            in_core[c] = 1;
+        }
+        for (int32_t c = 0; c < static_cast<int32_t>(m_status.size()); ++c) {
+            if (m_status[c] != REMOVED && !in_core[c]) {
+                m_status[c] = REMOVED;
+            }
+        }
+        m_changed.notify_all();
+        return true;
+    }
+
+    /**
+     * Marks \p clause as critical after a satisfiable check with the given \p model, and rotates the
+     * model to find further critical clauses. Returns the number of clauses found by rotation.
+     * If a refinement removed \p clause during the check, it stays removed; the model still
+     * satisfies all other clauses of the current set, so rotation remains sound.
+     */
+    uint64_t critical(int32_t clause, std::vector<int8_t>& model) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_checking;
+        if (m_status[clause] != REMOVED) {
+            m_status[clause] = CRITICAL;
+        }
+        uint64_t rotated = rotate(clause, model);
+        m_changed.notify_all();
+        return rotated;
+    }
+
+    // puts \p clause back into the queue after a check ran into its conflict limit
+    void postpone(int32_t clause) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_checking;
+        m_budget[clause] = m_budget[clause] < 0 ? -1 : m_budget[clause] * 2;
+        m_queue.push_back(clause);
+        m_changed.notify_all();
+    }
+
+    void wake() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_changed.notify_all();
+    }
+
+    // the clauses of the current set
+    std::vector<int32_t> current() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<int32_t> result;
+        for (int32_t c = 0; c < static_cast<int32_t>(m_status.size()); ++c) {
+            if (m_status[c] != REMOVED) {
+                result.push_back(c);
+            }
+        }
+        return result;
+    }
+
+    bool minimal() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return std::none_of(m_status.begin(), m_status.end(), [](uint8_t s) { return s == UNKNOWN; });
+    }
+
+    int32_t selector(int32_t clause) const {
+        return m_formula.max_var + 1 + clause;
+    }
+
+private:
+    static size_t index(int32_t lit) {
+        return 2 * std::abs(lit) + (lit < 0);
+    }
+
+    bool satisfied(int32_t lit, std::vector<int8_t> const& model) const {
+        return (lit > 0) == (model[std::abs(lit) - 1] > 0);
+    }
+
+    // recursive model rotation, \p model falsifies \p clause and satisfies all other clauses of the current set
+    uint64_t rotate(int32_t clause, std::vector<int8_t>& model) {
+        uint64_t found = 0;
+        for (int32_t i = m_formula.offsets[clause]; i < m_formula.offsets[clause + 1]; ++i) {
+            int32_t var = std::abs(m_formula.literals[i]);
+            int32_t lost = model[var - 1] > 0 ? var : -var;
+            model[var - 1] = -model[var - 1];
+            int32_t falsified = -1;
+            int32_t count = 0;
+            for (int32_t c : m_occurrences[index(lost)]) {
+                if (m_status[c] == REMOVED || c == clause) {
+                    continue;
+                }
+                bool sat = false;
+                for (int32_t j = m_formula.offsets[c]; j < m_formula.offsets[c + 1] && !sat; ++j) {
+                    sat = satisfied(m_formula.literals[j], model);
+                }
+                if (!sat && ++count == 1) {
+                    falsified = c;
+                }
+            }
+            if (count == 1 && m_status[falsified] == UNKNOWN) {
+                m_status[falsified] = CRITICAL;
+                found += 1 + rotate(falsified, model);
+            }
+            model[var - 1] = -model[var - 1];
+        }
+        return found;
+    }
+
+    mus_formula const& m_formula;
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::vector<uint8_t> m_status;
+    std::vector<int64_t> m_budget;
+    std::deque<int32_t> m_queue;
+    std::vector<std::vector<int32_t>> m_occurrences;
+    int32_t m_checking = 0;
+};
+
+struct mus_worker {
+    int32_t id;
+    void* solver = nullptr;
+    ipasir2_errorcode err = IPASIR2_E_OK;
+    uint64_t sat = 0;
+    uint64_t unsat = 0;
+    uint64_t unknown = 0;
+    uint64_t rotated = 0;
+    uint64_t stale = 0;
+};
+
+struct mus_deadline {
+    std::atomic<bool> expired { false };
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::time_point::max();
+
+    bool check() {
+        if (!expired.load(std::memory_order_relaxed) && std::chrono::steady_clock::now() >= end) {
+            expired.store(true, std::memory_order_relaxed);
+        }
+        return expired.load(std::memory_order_relaxed);
+    }
+};
+
+// Checks clauses of the current set on the worker's instance until all are decided or time is up
+inline ipasir2_errorcode mus_shrink(mus_worker& w, mus_state& state, mus_formula const& f, mus_deadline& limit) {
+    ipasir2_option_index options(w.solver);
+    ipasir2_option const* conflicts = options.find(IPASIR2_O_LIMITS_CONFLICTS);
+    std::vector<int32_t> assumptions;
+    std::vector<int32_t> core;
+    std::vector<int8_t> model(f.max_var);
+    int64_t budget = -1;
+    for (int32_t clause = state.take(assumptions, budget, limit.expired); clause >= 0; clause = state.take(assumptions, budget, limit.expired)) {
+        if (conflicts != nullptr && ipasir2_set_option(w.solver, conflicts, budget, 0) != IPASIR2_E_OK) {
+            conflicts = nullptr;
+        }
+        int result = 0;
+        ipasir2_errorcode err = ipasir2_solve(w.solver, &result, assumptions.data(), assumptions.size());
+        if (err == IPASIR2_E_OK && result == RESULT_UNSAT) {
+            err = ipasir2_core(w.solver, assumptions.data(), assumptions.size(), core);
+        }
+        else if (err == IPASIR2_E_OK && result == RESULT_SAT) {
+            err = ipasir2_model(w.solver, 1, f.max_var, model.data());
+            // variables which may take either value are set to false, so that rotation can flip them
+            std::replace(model.begin(), model.end(), static_cast<int8_t>(0), static_cast<int8_t>(-1));
+        }
+        if (err) {
+            state.postpone(clause);
+            limit.expired = true;
+            state.wake();
+            return err;
+        }
+        if (result == RESULT_UNSAT) {
+            ++w.unsat;
+            w.stale += !state.refine(clause, core);
+        }
+        else if (result == RESULT_SAT) {
+            ++w.sat;
+            w.rotated += state.critical(clause, model);
+        }
+        else {
+            ++w.unknown;
+            state.postpone(clause);
+        }
+    }
+    return IPASIR2_E_OK;
+}
+
+#endif // IPASIR2_MUS_STATE_H
@@ -0,0 +1,236 @@
+/**
+ * MIT License
+ *
+ * Parallel portfolio: runs N diversified instances of one backend on N threads.
+ *
+ * Instance 0 runs with the default configuration. The other instances get different initial
+ * phases and random values for the tunable options with small ranges, as advertised by
+ * ipasir2_options(). Learned clauses are exchanged through a clause_ring connected to
+ * ipasir2_set_export() and ipasir2_set_import(), and the first instance to finish stops
+ * the others through ipasir2_set_terminate(). A clause_filter keeps clauses learned by several
+ * instances from being shared more than once.
+ *
+ * Instances supporting the standard clause metadata (ipasir.proofmeta.clause) pass the LBD of
+ * shared clauses along, which allows limiting sharing by LBD (-g) instead of by length only.
+ * The ring stores clauses in slots of a fixed size, so sharing without a length limit (-l -1)
+ * still drops clauses longer than max_slot_length literals.
+ *
+ */
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ipasir2.h"
+#include "ipasir2_util.h"
+#include "clause_filter.h"
+#include "clause_ring.h"
+#include "dimacs.h"
+
+
+struct portfolio_instance {
+    int32_t id;
+    void* solver = nullptr;
+    clause_ring::endpoint endpoint;
+    int result = 0;
+    double seconds = 0;
+    ipasir2_errorcode err = IPASIR2_E_OK;
+};
+
+// Options with larger ranges (limits, sizes) are left alone, their defaults are usually deliberate
+const uint64_t max_diversified_range = 1024;
+
+// Slot size of the ring if the length of shared clauses is not limited
+const int32_t max_slot_length = 256;
+
+// Number of values of the option minus one, in uint64_t since the range may span all of int64_t
+uint64_t span(ipasir2_option const& option) {
+    return static_cast<uint64_t>(option.max) - static_cast<uint64_t>(option.min);
+}
+
+// The value offset positions above the minimum, wrapping around at the maximum
+int64_t nth_value(ipasir2_option const& option, uint64_t offset) {
+    uint64_t values = span(option) + 1;
+    return static_cast<int64_t>(static_cast<uint64_t>(option.min) + (values != 0 ? offset % values : offset));
+}
+
+void diversify(void* solver, int32_t id) {
+    if (id == 0) {
+        return;
+    }
+    std::mt19937_64 rng(id);
+    ipasir2_option const* options;
+    int count;
+    if (ipasir2_options(solver, &options, &count) != IPASIR2_E_OK) {
+        return;
+    }
+    for (int i = 0; i < count; ++i) {
+        ipasir2_option const& option = options[i];
+        std::string name = option.name;
+        if (option.indexed) {
+            if (name == ipasir2_standard_option_names[IPASIR2_O_VARIABLES_PHASE_INITIAL]) {
+                // index 0 sets the initial phase of all variables: alternate between false and true
+                ipasir2_set_option(solver, &option, id % 2 ? -1 : 1, 0);
+            }
+        }
+        else if (name.find("seed") != std::string::npos) {
+            ipasir2_set_option(solver, &option, nth_value(option, id), 0);
+        }
+        else if (option.tunable && span(option) <= max_diversified_range && rng() % 2) {
+            ipasir2_set_option(solver, &option, nth_value(option, rng()), 0);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    int32_t threads = std::thread::hardware_concurrency();
+    int32_t max_length = 8;
+    uint32_t filter_size = 1 << 20;
+    int32_t max_lbd = -1;
+    char const* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-t" && i + 1 < argc) {
+            threads = std::stoi(argv[++i]);
+        }
+        else if (arg == "-l" && i + 1 < argc) {
+            max_length = std::stoi(argv[++i]);
+        }
+        else if (arg == "-g" && i + 1 < argc) {
+            max_lbd = std::stoi(argv[++i]);
+        }
+        else if (arg == "-f" && i + 1 < argc) {
+            filter_size = std::stoul(argv[++i]);
+        }
+        else {
+            path = argv[i];
+        }
+    }
+    if (path == nullptr) {
+        std::cerr << "Usage: " << argv[0] << " [-t threads] [-l max shared clause length, -1 for up to " << max_slot_length << "] [-g max shared clause LBD]"
+            << " [-f filter entries, 0 disables] <file.cnf>" << std::endl;
+        return 1;
+    }
+    threads = std::max(threads, 1);
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "c solver: " << signature << ", " << threads << " instances" << std::endl;
+
+    std::vector<int32_t> literals;
+    std::vector<int32_t> offsets { 0 };
+    int32_t max_var = 0;
+    try {
+        dimacs_reader reader(path);
+        while (reader.next() == dimacs_reader::CLAUSES) {
+            literals.insert(literals.end(), reader.literals(), reader.literals() + reader.offsets()[reader.count()]);
+            for (int32_t i = 1; i <= reader.count(); ++i) {
+                offsets.push_back(offsets.back() + reader.offsets()[i] - reader.offsets()[i - 1]);
+            }
+        }
+        max_var = reader.max_variable();
+    }
+    catch (std::runtime_error const& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    // the ring needs a bound for its slots, an unlimited length is capped
+    clause_ring ring(1 << 16, max_length < 0 ? max_slot_length : max_length);
+    ring.set_max_lbd(max_lbd);
+    std::unique_ptr<clause_filter> filter(filter_size > 0 ? new clause_filter(filter_size) : nullptr);
+    std::atomic<int32_t> winner { -1 };
+    std::vector<portfolio_instance> instances(threads);
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int32_t id = 0; id < threads; ++id) {
+        workers.emplace_back([&, id]() {
+            portfolio_instance& inst = instances[id];
+            inst.id = id;
+            inst.err = ipasir2_init(&inst.solver);
+            if (inst.err) return;
+            diversify(inst.solver, id);
+            ipasir2_option_index options(inst.solver);
+            ipasir2_option const* handle = options.find(IPASIR2_O_PROOFMETA_CLAUSE);
+            inst.endpoint.clause_meta = handle != nullptr && ipasir2_set_option(inst.solver, handle, 1, 0) == IPASIR2_E_OK;
+            handle = options.find(IPASIR2_O_EXPORT_MAX_LBD);
+            if (handle != nullptr && max_lbd >= 0) {
+                ipasir2_set_option(inst.solver, handle, max_lbd, 0);
+            }
+            inst.err = ipasir2_add_formula(inst.solver, literals.data(), offsets.data(), offsets.size() - 1);
+            if (inst.err) return;
+            if (threads > 1) {
+                // sharing is optional, solvers without export or import still take part in the race
+                inst.endpoint.filter = filter.get();
+                ring.attach(inst.endpoint, inst.solver, id);
+            }
+            ipasir2_set_terminate(inst.solver, &winner, [](void* data) {
+                return static_cast<int>(static_cast<std::atomic<int32_t>*>(data)->load(std::memory_order_relaxed) >= 0);
+            });
+            inst.err = ipasir2_solve(inst.solver, &inst.result, nullptr, 0);
+            inst.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (!inst.err && inst.result != RESULT_UNKNOWN) {
+                int32_t none = -1;
+                winner.compare_exchange_strong(none, id);
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (portfolio_instance const& inst : instances) {
+        std::cout << "c instance " << inst.id << ": result " << inst.result << " after " << inst.seconds << " s";
+        std::cout << ", exported " << inst.endpoint.exported << ", filtered " << inst.endpoint.filtered;
+        std::cout << ", imported " << inst.endpoint.imported;
+        std::cout << ", lost " << inst.endpoint.position.lost;
+        if (inst.endpoint.batched) {
+            std::cout << ", batched export";
+        }
+        if (inst.endpoint.clause_meta) {
+            std::cout << ", clause metadata";
+        }
+        if (inst.err) {
+            std::cout << ", error " << inst.err;
+        }
+        std::cout << std::endl;
+    }
+
+    if (filter) {
+        clause_filter::stats stats = filter->statistics();
+        std::cout << "c filter: checked " << stats.checked << ", rejected " << stats.rejected;
+        std::cout << " (" << 100 * stats.hit_rate() << "%)" << std::endl;
+    }
+
+    int result = RESULT_UNKNOWN;
+    if (winner >= 0) {
+        portfolio_instance& inst = instances[winner];
+        result = inst.result;
+        std::cout << "c winner: instance " << inst.id << " after " << inst.seconds << " s" << std::endl;
+        if (result == RESULT_SAT) {
+            puts("s SATISFIABLE");
+            ipasir2_print_model(inst.solver, max_var);
+        }
+        else {
+            puts("s UNSATISFIABLE");
+        }
+    }
+    else {
+        puts("s UNKNOWN");
+    }
+
+    for (portfolio_instance& inst : instances) {
+        if (inst.solver != nullptr) {
+            ipasir2_release(inst.solver);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,180 @@
+/**
+ * MIT License
+ *
+ * Races several IPASIR-2 backends on one DIMACS CNF file within a single process.
+ *
+ * Usage: race <file.cnf> <backend.so>...
+ *
+ * Each backend is loaded from its shared library with backend_library, so the same backend
+ * may also be given several times. Every backend solves the formula in its own thread, and
+ * the first one to find a definite result stops the others through their terminate callbacks.
+ * The result is printed in the usual format, followed by the time of each backend.
+ *
+ */
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ipasir2.h"
+#include "dimacs.h"
+#include "loader.h"
+
+
+struct formula {
+    std::vector<int32_t> literals;
+    std::vector<int32_t> offsets { 0 };
+    int32_t max_variable = 0;
+};
+
+formula read_formula(std::string const& path) {
+    formula f;
+    dimacs_reader reader(path);
+    for (dimacs_reader::event e = reader.next(); e != dimacs_reader::END; e = reader.next()) {
+        if (e == dimacs_reader::ASSUMPTIONS) {
+            throw std::runtime_error("iCNF files are not supported");
+        }
+        int32_t base = f.literals.size();
+        f.literals.insert(f.literals.end(), reader.literals(), reader.literals() + reader.offsets()[reader.count()]);
+        for (int32_t i = 1; i <= reader.count(); ++i) {
+            f.offsets.push_back(base + reader.offsets()[i]);
+        }
+    }
+    f.max_variable = reader.max_variable();
+    return f;
+}
+
+struct racer {
+    backend_library* backend;
+    void* solver = nullptr;
+    int result = 0;
+    ipasir2_errorcode error = IPASIR2_E_OK;
+    double seconds = 0;
+};
+
+struct race {
+    std::atomic<int> winner { -1 };
+
+    static int terminate(void* data) {
+        return static_cast<race*>(data)->winner.load(std::memory_order_relaxed) >= 0;
+    }
+};
+
+ipasir2_errorcode run(racer& r, formula const& f, race& state, int index) {
+    backend_library& b = *r.backend;
+    ipasir2_errorcode err = b.init(&r.solver);
+    if (err) return err;
+    b.set_terminate(r.solver, &state, race::terminate);
+    int32_t count = f.offsets.size() - 1;
+    err = b.add_clauses(r.solver, f.literals.data(), f.offsets.data(), count, 0, nullptr);
+    if (err == IPASIR2_E_UNSUPPORTED) {
+        err = IPASIR2_E_OK;
+        for (int32_t i = 0; i < count && !err; ++i) {
+            err = b.add(r.solver, f.literals.data() + f.offsets[i], f.offsets[i + 1] - f.offsets[i], 0, nullptr);
+        }
+    }
+    if (err) return err;
+    err = b.solve(r.solver, &r.result, nullptr, 0);
+    if (err) return err;
+    if (r.result == 10 || r.result == 20) {
+        int expected = -1;
+        state.winner.compare_exchange_strong(expected, index);
+    }
+    return IPASIR2_E_OK;
+}
+
+void print_model(backend_library& b, void* solver, int32_t max_variable) {
+    std::string line = "v";
+    for (int32_t var = 1; var <= max_variable; ++var) {
+        int32_t value = 0;
+        if (b.value(solver, var, &value) != IPASIR2_E_OK) {
+            std::cout << "c ipasir2_value() is not supported by " << b.name() << std::endl;
+            return;
+        }
+        line += ' ';
+        line += std::to_string(value < 0 ? -var : var);
+        if (line.size() > 76) {
+            puts(line.c_str());
+            line = "v";
+        }
+    }
+    line += " 0";
+    puts(line.c_str());
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <file.cnf> <backend.so>..." << std::endl;
+        return 1;
+    }
+
+    formula f;
+    std::vector<std::unique_ptr<backend_library>> backends;
+    try {
+        f = read_formula(argv[1]);
+        for (int i = 2; i < argc; ++i) {
+            backends.emplace_back(new backend_library(argv[i]));
+        }
+    }
+    catch (std::runtime_error const& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    race state;
+    std::vector<racer> racers;
+    for (auto& backend : backends) {
+        racers.push_back({ backend.get() });
+    }
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < racers.size(); ++i) {
+        threads.emplace_back([&, i]() {
+            racers[i].error = run(racers[i], f, state, i);
+            racers[i].seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    for (racer const& r : racers) {
+        std::cout << "c " << r.backend->name() << " (" << r.backend->path() << "): ";
+        if (r.error) {
+            std::cout << "error " << r.error;
+        }
+        else {
+            std::cout << "result " << r.result;
+        }
+        std::cout << ", " << r.seconds << " s" << std::endl;
+    }
+
+    int winner = state.winner.load();
+    if (winner < 0) {
+        puts("s UNKNOWN");
+    }
+    else {
+        racer& w = racers[winner];
+        std::cout << "c winner: " << w.backend->name() << std::endl;
+        if (w.result == 10) {
+            puts("s SATISFIABLE");
+            print_model(*w.backend, w.solver, f.max_variable);
+        }
+        else {
+            puts("s UNSATISFIABLE");
+        }
+    }
+
+    for (racer& r : racers) {
+        if (r.solver != nullptr) {
+            r.backend->release(r.solver);
+        }
+    }
+    return winner < 0 ? 0 : racers[winner].result;
+}
@@ -0,0 +1,539 @@
+/**
+ * MIT License
+ *
+ * Replays IPASIR-2 call traces recorded with the ipasir2_trace library against the linked backend.
+ *
+ * Each recording thread is replayed on its own thread, and each recorded solver instance is
+ * replaced by a new instance of the backend. The tool reports the wall time of each solve call
+ * next to the recorded time, the time spent adding clauses and the total time. Solve results
+ * differing from the trace are counted, which is useful when comparing solver versions.
+ *
+ * With -c, callbacks are replayed as well: import callbacks deliver the clauses which were imported
+ * in the recorded run at the same import calls, and the terminate callback stops the solver at the
+ * same terminate poll as in the recorded run. Export, delete and fixed callbacks only count their
+ * calls. Note that poll counts are only meaningful when replaying against the recorded backend.
+ * Without -c, solve calls which were terminated in the recorded run are run to completion.
+ *
+ */
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ipasir2.h"
+#include "ipasir2_util.h"
+#include "trace_reader.h"
+
+
+typedef std::chrono::steady_clock replay_clock;
+
+double seconds_since(replay_clock::time_point start) {
+    return std::chrono::duration<double>(replay_clock::now() - start).count();
+}
+
+
+struct imported_clause {
+    std::vector<int32_t> literals;
+    int32_t forgettable;
+};
+
+/**
+ * Callback events recorded during one solve call
+ */
+struct callback_script {
+    int64_t terminate_at = 0;  // terminate poll which returned non-zero, 0 for none
+    int64_t polls = 0;
+    std::vector<std::vector<imported_clause>> imports;  // clauses added by each import call, in order
+    size_t next_import = 0;
+};
+
+struct replay_solver {
+    int32_t number;
+    void* solver = nullptr;
+    std::unique_ptr<ipasir2_option_index> options;
+    callback_script script;
+    uint64_t exported = 0;
+    uint64_t deleted = 0;
+    uint64_t fixed = 0;
+};
+
+struct solve_report {
+    int32_t solver;
+    int32_t assumptions;
+    int result;
+    int recorded;
+    double seconds;
+    double recorded_seconds;
+};
+
+struct thread_report {
+    size_t threads = 0;
+    std::vector<solve_report> solves;
+    double add_seconds = 0;
+    double solve_seconds = 0;
+    uint64_t calls = 0;
+    uint64_t errors = 0;
+};
+
+
+/**
+ * Maps recorded solver instances to replayed ones. A solver may be used by a different thread
+ * than the one which created it, but the schedule replays its init or clone call before, since
+ * the recorded call returned before the pointer could be passed on. So a lookup does not wait:
+ * an instance which is missing was never created, released before, or failed to be created.
+ */
+class solver_map {
+public:
+    replay_solver* create(uint64_t recorded, void* solver) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::unique_ptr<replay_solver>& entry = m_solvers[recorded];
+        entry.reset(new replay_solver());
+        entry->number = m_count++;
+        entry->solver = solver;
+        return entry.get();
+    }
+
+    // returns nullptr if there is no replayed instance for the recorded one
+    replay_solver* find(uint64_t recorded) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_solvers.find(recorded);
+        return it != m_solvers.end() ? it->second.get() : nullptr;
+    }
+
+    void erase(uint64_t recorded) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_solvers.erase(recorded);
+    }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<uint64_t, std::unique_ptr<replay_solver>> m_solvers;
+    int32_t m_count = 0;
+};
+
+
+int terminate_callback(void* data) {
+    callback_script& script = static_cast<replay_solver*>(data)->script;
+    ++script.polls;
+    return static_cast<int>(script.terminate_at > 0 && script.polls >= script.terminate_at);
+}
+
+void import_callback(void* data) {
+    replay_solver* rs = static_cast<replay_solver*>(data);
+    callback_script& script = rs->script;
+    if (script.next_import < script.imports.size()) {
+        for (imported_clause const& clause : script.imports[script.next_import++]) {
+            ipasir2_add(rs->solver, clause.literals.data(), clause.literals.size(), clause.forgettable, nullptr);
+        }
+    }
+}
+
+void export_callback(void* data, int32_t const*, int32_t, void*) {
+    ++static_cast<replay_solver*>(data)->exported;
+}
+
+void export_batch_callback(void* data, int32_t const*, int32_t const*, int32_t count, void* const*) {
+    static_cast<replay_solver*>(data)->exported += count;
+}
+
+void delete_callback(void* data, int32_t const*, int32_t, void*) {
+    ++static_cast<replay_solver*>(data)->deleted;
+}
+
+void fixed_callback(void* data, int32_t) {
+    ++static_cast<replay_solver*>(data)->fixed;
+}
+
+ipasir2_option const* option_handle(replay_solver* rs, std::string const& name) {
+    if (!rs->options) {
+        rs->options.reset(new ipasir2_option_index(rs->solver));
+    }
+    return rs->options->find(name);
+}
+
+/**
+ * Preserves the order of calls across threads: a call is replayed only after all calls of other
+ * threads which returned before it was started in the recorded run have been replayed.
+ */
+class replay_schedule {
+public:
+    explicit replay_schedule(std::vector<std::vector<trace_record>> const& threads) : m_threads(threads), m_done(new std::atomic<size_t>[threads.size()]) {
+        for (size_t t = 0; t < threads.size(); ++t) {
+            m_done[t].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::vector<trace_record> const& records(size_t thread) const {
+        return m_threads[thread];
+    }
+
+    // whether the calls of other threads which precede records(thread)[i] have been replayed, needed[u] tracks the progress per thread
+    bool ready(size_t thread, size_t i, std::vector<size_t>& needed) const {
+        uint64_t start = m_threads[thread][i].header.timestamp;
+        for (size_t u = 0; u < m_threads.size(); ++u) {
+            if (u == thread) {
+                continue;
+            }
+            std::vector<trace_record> const& other = m_threads[u];
+            while (needed[u] < other.size() && other[needed[u]].header.timestamp + other[needed[u]].header.duration < start) {
+                ++needed[u];
+            }
+            if (m_done[u].load(std::memory_order_acquire) < needed[u]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // waits until ready()
+    void wait(size_t thread, size_t i, std::vector<size_t>& needed) const {
+        for (int spins = 0; !ready(thread, i, needed); ++spins) {
+            if (spins < 100) {
+                std::this_thread::yield();
+            }
+            else {
+                std::this_thread::sleep_for(std::chrono::microseconds(20));
+            }
+        }
+    }
+
+    void done(size_t thread, size_t count) {
+        m_done[thread].store(count, std::memory_order_release);
+    }
+
+private:
+    std::vector<std::vector<trace_record>> const& m_threads;
+    std::unique_ptr<std::atomic<size_t>[]> m_done;
+};
+
+// builds the callback script from the in-callback records preceding a solve record
+void build_script(std::vector<trace_record> const& records, size_t first, size_t last, callback_script& script) {
+    script = callback_script();
+    std::vector<imported_clause> clauses;  // added by the next import call
+    std::vector<int32_t> literals;
+    std::vector<int32_t> offsets;
+    for (size_t i = first; i < last; ++i) {
+        trace_record const& record = records[i];
+        trace_payload payload(record);
+        if (record.header.function == IPASIR2_TRACE_CB_TERMINATE) {
+            payload.get<int32_t>();
+            script.terminate_at = payload.get<int64_t>();
+        }
+        else if (record.header.function == IPASIR2_TRACE_ADD) {
+            int32_t forgettable = payload.get<int32_t>();
+            payload.get(literals, payload.get<int32_t>());
+            clauses.push_back({ literals, forgettable });
+        }
+        else if (record.header.function == IPASIR2_TRACE_ADD_CLAUSES) {
+            int32_t forgettable = payload.get<int32_t>();
+            int32_t count = payload.get<int32_t>();
+            payload.get(offsets, count + 1);
+            payload.get(literals, offsets[count] - offsets[0]);
+            for (int32_t c = 0; c < count; ++c) {
+                int32_t const* clause = literals.data() + offsets[c] - offsets[0];
+                clauses.push_back({ std::vector<int32_t>(clause, clause + offsets[c + 1] - offsets[c]), forgettable });
+            }
+        }
+        else if (record.header.function == IPASIR2_TRACE_CB_IMPORT) {
+            script.imports.push_back(std::move(clauses));
+            clauses.clear();
+        }
+    }
+}
+
+void replay_thread(size_t thread, replay_schedule& schedule, solver_map& solvers, bool callbacks, thread_report& report) {
+    std::vector<trace_record> const& records = schedule.records(thread);
+    std::vector<size_t> needed(report.threads, 0);
+    std::vector<int32_t> literals;
+    std::vector<int32_t> offsets;
+    std::vector<int64_t> values;
+    std::vector<int64_t> indices;
+    std::vector<int8_t> model;
+    size_t callback_records = 0;  // number of in-callback records preceding the current record
+    replay_clock::time_point add_start;
+    bool adding = false;
+
+    for (size_t i = 0; i < records.size(); ++i) {
+        trace_record const& record = records[i];
+        if (record.header.flags & IPASIR2_TRACE_IN_CALLBACK) {
+            ++callback_records;
+            schedule.done(thread, i + 1);
+            continue;
+        }
+        if (!schedule.ready(thread, i, needed)) {
+            // time spent waiting for other threads is not add time
+            if (adding) {
+                report.add_seconds += seconds_since(add_start);
+                adding = false;
+            }
+            schedule.wait(thread, i, needed);
+        }
+
+        // consecutive add calls are timed together, to keep the clock overhead out of the measurement
+        bool add = record.header.function == IPASIR2_TRACE_ADD || record.header.function == IPASIR2_TRACE_ADD_CLAUSES;
+        if (add && !adding) {
+            add_start = replay_clock::now();
+        }
+        else if (!add && adding) {
+            report.add_seconds += seconds_since(add_start);
+        }
+        adding = add;
+
+        trace_payload payload(record);
+        replay_solver* rs = nullptr;
+        ++report.calls;
+        if (record.header.function != IPASIR2_TRACE_SIGNATURE && record.header.function != IPASIR2_TRACE_INIT) {
+            // looked up for each call, since another thread may have released the instance in between
+            rs = solvers.find(record.header.solver);
+            if (rs == nullptr) {
+                ++report.errors;
+                callback_records = 0;
+                schedule.done(thread, i + 1);
+                continue;
+            }
+        }
+        ipasir2_errorcode err = IPASIR2_E_OK;
+
+        switch (record.header.function) {
+            case IPASIR2_TRACE_SIGNATURE: {
+                char const* signature;
+                err = ipasir2_signature(&signature);
+                break;
+            }
+            case IPASIR2_TRACE_INIT: {
+                void* solver = nullptr;
+                err = ipasir2_init(&solver);
+                if (record.header.error == IPASIR2_E_OK && err == IPASIR2_E_OK) {
+                    solvers.create(record.header.solver, solver);
+                }
+                break;
+            }
+            case IPASIR2_TRACE_RELEASE:
+                err = ipasir2_release(rs->solver);
+                solvers.erase(record.header.solver);
+                break;
+            case IPASIR2_TRACE_CLONE: {
+                uint64_t recorded = payload.get<int64_t>();
+                void* clone = nullptr;
+                err = ipasir2_clone != nullptr ? ipasir2_clone(rs->solver, &clone) : IPASIR2_E_UNSUPPORTED;
+                if (record.header.error == IPASIR2_E_OK && err == IPASIR2_E_OK) {
+                    solvers.create(recorded, clone);
+                }
+                break;
+            }
+            case IPASIR2_TRACE_OPTIONS: {
+                ipasir2_option const* options;
+                int count;
+                err = ipasir2_options(rs->solver, &options, &count);
+                break;
+            }
+            case IPASIR2_TRACE_SET_OPTION: {
+                std::string name = payload.get_string();
+                int64_t value = payload.get<int64_t>();
+                int64_t index = payload.get<int64_t>();
+                ipasir2_option const* handle = option_handle(rs, name);
+                err = handle != nullptr ? ipasir2_set_option(rs->solver, handle, value, index) : IPASIR2_E_UNSUPPORTED_OPTION;
+                break;
+            }
+            case IPASIR2_TRACE_SET_OPTION_ARRAY: {
+                std::string name = payload.get_string();
+                int64_t first = payload.get<int64_t>();
+                int32_t count = payload.get<int32_t>();
+                bool has_indices = payload.get<int32_t>() != 0;
+                payload.get(values, count);
+                if (has_indices) {
+                    payload.get(indices, count);
+                }
+                ipasir2_option const* handle = option_handle(rs, name);
+                err = handle != nullptr ? ipasir2_set_option_values(rs->solver, handle, values.data(), has_indices ? indices.data() : nullptr, first, count)
+                    : IPASIR2_E_UNSUPPORTED_OPTION;
+                break;
+            }
+            case IPASIR2_TRACE_ADD: {
+                int32_t forgettable = payload.get<int32_t>();
+                payload.get(literals, payload.get<int32_t>());
+                err = ipasir2_add(rs->solver, literals.data(), literals.size(), forgettable, nullptr);
+                break;
+            }
+            case IPASIR2_TRACE_ADD_CLAUSES: {
+                int32_t forgettable = payload.get<int32_t>();
+                int32_t count = payload.get<int32_t>();
+                payload.get(offsets, count + 1);
+                payload.get(literals, offsets[count] - offsets[0]);
+                int32_t base = offsets[0];
+                for (int32_t& offset : offsets) {
+                    offset -= base;
+                }
+                err = ipasir2_add_clauses != nullptr ? ipasir2_add_clauses(rs->solver, literals.data(), offsets.data(), count, forgettable, nullptr)
+                    : IPASIR2_E_UNSUPPORTED;
+                for (int32_t c = 0; err == IPASIR2_E_UNSUPPORTED && c < count; ++c) {
+                    err = ipasir2_add(rs->solver, literals.data() + offsets[c], offsets[c + 1] - offsets[c], forgettable, nullptr);
+                    err = err == IPASIR2_E_OK && c + 1 < count ? IPASIR2_E_UNSUPPORTED : err;
+                }
+                break;
+            }
+            case IPASIR2_TRACE_SOLVE: {
+                int recorded = payload.get<int32_t>();
+                payload.get(literals, payload.get<int32_t>());
+                if (callbacks) {
+                    build_script(records, i - callback_records, i, rs->script);
+                }
+                int result = 0;
+                replay_clock::time_point start = replay_clock::now();
+                err = ipasir2_solve(rs->solver, &result, literals.data(), literals.size());
+                double seconds = seconds_since(start);
+                report.solve_seconds += seconds;
+                report.solves.push_back({ rs->number, static_cast<int32_t>(literals.size()), result, recorded, seconds, record.header.duration * 1e-9 });
+                break;
+            }
+            case IPASIR2_TRACE_VALUE: {
+                int32_t lit = payload.get<int32_t>();
+                int32_t value;
+                err = ipasir2_value(rs->solver, lit, &value);
+                break;
+            }
+            case IPASIR2_TRACE_VALUES: {
+                int32_t first = payload.get<int32_t>();
+                int32_t count = payload.get<int32_t>();
+                model.resize(count);
+                err = ipasir2_model(rs->solver, first, count, model.data());
+                break;
+            }
+            case IPASIR2_TRACE_FAILED: {
+                int32_t lit = payload.get<int32_t>();
+                int failed;
+                err = ipasir2_failed(rs->solver, lit, &failed);
+                break;
+            }
+            case IPASIR2_TRACE_FAILED_CORE: {
+                int32_t capacity = payload.get<int32_t>();
+                int32_t size;
+                literals.resize(capacity);
+                err = ipasir2_failed_core != nullptr ? ipasir2_failed_core(rs->solver, literals.data(), capacity, &size) : IPASIR2_E_UNSUPPORTED;
+                break;
+            }
+            case IPASIR2_TRACE_SET_TERMINATE:
+                if (callbacks) {
+                    err = ipasir2_set_terminate(rs->solver, rs, payload.get<int32_t>() ? terminate_callback : nullptr);
+                }
+                break;
+            case IPASIR2_TRACE_SET_EXPORT: {
+                bool enabled = payload.get<int32_t>() != 0;
+                int32_t max_length = payload.get<int32_t>();
+                if (callbacks) {
+                    err = ipasir2_set_export(rs->solver, rs, max_length, enabled ? export_callback : nullptr);
+                }
+                break;
+            }
+            case IPASIR2_TRACE_SET_EXPORT_BATCH: {
+                bool enabled = payload.get<int32_t>() != 0;
+                int32_t max_length = payload.get<int32_t>();
+                if (callbacks) {
+                    // without batched export, the clauses are counted one by one
+                    err = ipasir2_set_export_batch != nullptr ? ipasir2_set_export_batch(rs->solver, rs, max_length, enabled ? export_batch_callback : nullptr)
+                        : ipasir2_set_export(rs->solver, rs, max_length, enabled ? export_callback : nullptr);
+                }
+                break;
+            }
+            case IPASIR2_TRACE_SET_DELETE:
+                if (callbacks) {
+                    err = ipasir2_set_delete(rs->solver, rs, payload.get<int32_t>() ? delete_callback : nullptr);
+                }
+                break;
+            case IPASIR2_TRACE_SET_IMPORT:
+                if (callbacks) {
+                    err = ipasir2_set_import(rs->solver, rs, payload.get<int32_t>() ? import_callback : nullptr);
+                }
+                break;
+            case IPASIR2_TRACE_SET_FIXED:
+                if (callbacks) {
+                    err = ipasir2_set_fixed(rs->solver, rs, payload.get<int32_t>() ? fixed_callback : nullptr);
+                }
+                break;
+            default:
+                break;
+        }
+        callback_records = 0;
+        report.errors += (err != record.header.error);
+        schedule.done(thread, i + 1);
+    }
+    if (adding) {
+        report.add_seconds += seconds_since(add_start);
+    }
+}
+
+int main(int argc, char** argv) {
+    bool callbacks = false;
+    char const* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "-c") {
+            callbacks = true;
+        }
+        else {
+            path = argv[i];
+        }
+    }
+    if (path == nullptr) {
+        std::cerr << "Usage: " << argv[0] << " [-c] <file.trace>" << std::endl;
+        std::cerr << "  -c: replay callbacks at the recorded points" << std::endl;
+        return 1;
+    }
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "c solver: " << signature << std::endl;
+
+    try {
+        trace_reader trace(path);
+        std::cout << "c trace: " << trace.records() << " records from " << trace.threads().size() << " threads" << std::endl;
+
+        solver_map solvers;
+        replay_schedule schedule(trace.threads());
+        std::vector<thread_report> reports(trace.threads().size());
+        std::vector<std::thread> workers;
+        replay_clock::time_point start = replay_clock::now();
+        for (size_t t = 0; t < trace.threads().size(); ++t) {
+            reports[t].threads = trace.threads().size();
+            workers.emplace_back(replay_thread, t, std::ref(schedule), std::ref(solvers), callbacks, std::ref(reports[t]));
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        double total = seconds_since(start);
+
+        double add_seconds = 0;
+        double solve_seconds = 0;
+        uint64_t calls = 0;
+        uint64_t errors = 0;
+        uint64_t differing = 0;
+        for (size_t t = 0; t < reports.size(); ++t) {
+            for (solve_report const& s : reports[t].solves) {
+                printf("c solve: thread %zu solver %d, %d assumptions, result %d (recorded %d), %.6f s (recorded %.6f s)\n",
+                    t, s.solver, s.assumptions, s.result, s.recorded, s.seconds, s.recorded_seconds);
+                differing += (s.result != s.recorded);
+            }
+            add_seconds += reports[t].add_seconds;
+            solve_seconds += reports[t].solve_seconds;
+            calls += reports[t].calls;
+            errors += reports[t].errors;
+        }
+        printf("c calls: %lu, error codes differing from the trace: %lu\n", static_cast<unsigned long>(calls), static_cast<unsigned long>(errors));
+        printf("c solve results differing from the trace: %lu\n", static_cast<unsigned long>(differing));
+        printf("c add time: %.6f s\n", add_seconds);
+        printf("c solve time: %.6f s\n", solve_seconds);
+        printf("c total time: %.6f s\n", total);
+    }
+    catch (std::runtime_error const& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * MIT License
+ *
+ * Solves a DIMACS CNF or incremental iCNF file.
+ *
+ * Usage: solve [-p proof file] [-l LRAT instead of DRAT] <file.cnf|file.icnf>
+ *
+ * For iCNF files, the formula is solved under the assumptions of each "a <lits> 0" line,
+ * using the clauses read up to that line. Results are printed in the usual format:
+ * "s SATISFIABLE" followed by "v" lines, or "s UNSATISFIABLE", followed by the
+ * failed assumptions in an "f" line for iCNF files.
+ *
+ * With -p, the learned and deleted clauses are written into a binary DRAT (or, with -l, LRAT)
+ * proof by a proof_writer (src/proof/proof_writer.h).
+ *
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ipasir2.h"
+#include "ipasir2_util.h"
+#include "dimacs.h"
+#include "proof_writer.h"
+
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void print_core(void* solver, std::vector<int32_t> const& assumptions) {
+    std::vector<int32_t> core;
+    ipasir2_errorcode err = ipasir2_core(solver, assumptions.data(), assumptions.size(), core);
+    if (err) {
+        std::cout << "c ipasir2_failed_core() returned " << err << std::endl;
+        return;
+    }
+    std::string line = "f";
+    for (int32_t lit : core) {
+        line += ' ';
+        line += std::to_string(lit);
+    }
+    line += " 0";
+    puts(line.c_str());
+}
+
+int solve(void* solver, dimacs_reader& reader, std::vector<int32_t> const& assumptions, bool print_failed) {
+    int result;
+    auto start = std::chrono::steady_clock::now();
+    ipasir2_errorcode err = ipasir2_solve(solver, &result, assumptions.data(), assumptions.size());
+    if (err) {
+        std::cout << "c ipasir2_solve() returned " << err << std::endl;
+        return -1;
+    }
+    std::cout << "c solve time: " << seconds_since(start) << " s" << std::endl;
+
+    if (result == RESULT_SAT) {
+        puts("s SATISFIABLE");
+        ipasir2_print_model(solver, reader.max_variable());
+    }
+    else if (result == RESULT_UNSAT) {
+        puts("s UNSATISFIABLE");
+        if (print_failed) {
+            print_core(solver, assumptions);
+        }
+    }
+    else {
+        puts("s UNKNOWN");
+    }
+    fflush(stdout);
+    return result;
+}
+
+int main(int argc, char** argv) {
+    char const* proof_path = nullptr;
+    proof_writer::format proof_format = proof_writer::DRAT;
+    char const* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-p" && i + 1 < argc) {
+            proof_path = argv[++i];
+        }
+        else if (arg == "-l") {
+            proof_format = proof_writer::LRAT;
+        }
+        else {
+            path = argv[i];
+        }
+    }
+    if (path == nullptr) {
+        std::cerr << "Usage: " << argv[0] << " [-p proof file] [-l LRAT instead of DRAT] <file.cnf|file.icnf>" << std::endl;
+        return 1;
+    }
+
+    char const* signature;
+    ipasir2_signature(&signature);
+    std::cout << "c solver: " << signature << std::endl;
+
+    void* solver;
+    ipasir2_errorcode err = ipasir2_init(&solver);
+    if (err) {
+        std::cerr << "ipasir2_init() returned " << err << std::endl;
+        return 1;
+    }
+
+    int result = 0;
+    std::unique_ptr<proof_writer> proof;
+    try {
+        if (proof_path != nullptr) {
+            proof.reset(new proof_writer(proof_path, proof_format));
+            err = proof->attach(solver);
+            if (err) {
+                throw std::runtime_error("Cannot write a proof, the solver returned " + ipasir2_errorcode_to_string(err));
+            }
+        }
+        dimacs_reader reader(path);
+        auto start = std::chrono::steady_clock::now();
+        double load_time = 0;
+        int solves = 0;
+        bool unsolved = false;  // whether clauses were added after the last solve call
+        for (dimacs_reader::event ev = reader.next(); ev != dimacs_reader::END && result >= 0; ev = reader.next()) {
+            if (ev == dimacs_reader::CLAUSES) {
+                unsolved = true;
+                if (proof) {
+                    err = proof->add_clauses(solver, reader.literals(), reader.offsets(), reader.count());
+                }
+                else {
+                    err = ipasir2_add_formula(solver, reader.literals(), reader.offsets(), reader.count());
+                }
+                if (err) {
+                    std::cerr << "ipasir2_add_clauses() returned " << err << std::endl;
+                    result = -1;
+                }
+            }
+            else {
+                load_time += seconds_since(start);
+                result = solve(solver, reader, reader.assumptions(), true);
+                ++solves;
+                unsolved = false;
+                start = std::chrono::steady_clock::now();
+            }
+        }
+        load_time += seconds_since(start);
+        std::cout << "c parse and load time: " << load_time << " s" << std::endl;
+
+        // plain DIMACS files and iCNF files ending in clauses (or without any "a" line) get a final solve call
+        if (result >= 0 && (!reader.incremental() || unsolved || solves == 0)) {
+            result = solve(solver, reader, {}, false);
+            if (result == RESULT_UNSAT && proof) {
+                proof->conclude();
+            }
+        }
+    }
+    catch (std::runtime_error const& e) {
+        std::cerr << e.what() << std::endl;
+        result = -1;
+    }
+
+    if (proof) {
+        auto start = std::chrono::steady_clock::now();
+        bool written = proof->close();
+        proof_writer::stats stats = proof->statistics();
+        std::cout << "c proof: " << stats.learned << " learned, " << stats.deleted << " deleted, " << stats.bytes << " bytes, ";
+        std::cout << stats.delayed << " delayed buffers, " << seconds_since(start) << " s to close" << std::endl;
+        if (stats.incomplete > 0) {
+            std::cout << "c proof incomplete: " << stats.incomplete << " learned clauses without ID or hints" << std::endl;
+        }
+        if (!written) {
+            std::cerr << "Writing the proof failed" << std::endl;
+            result = -1;
+        }
+    }
+
+    ipasir2_release(solver);
+    return result < 0 ? 1 : result;
+}
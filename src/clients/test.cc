@@ -11,7 +11,28 @@
 #include "doctest.h"
 
 #include "ipasir2.h"
+#include "ipasir2.hpp"
+#include "ipasir2_async.hpp"
+#include "ipasir2_batch.hpp"
+#include "ipasir2_pool.hpp"
 #include "ipasir2_util.h"
+#include "clause_filter.h"
+#include "clause_ring.h"
+#include "loader.h"
+#include "mus_state.h"
+#include "proof_writer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 
 TEST_CASE("Trivial SAT / UNSAT") {
@@ -57,4 +78,776 @@ TEST_CASE("Trivial SAT / UNSAT") {
 
     ret = ipasir2_release(solver);
     CHECK(ret == IPASIR2_E_OK);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Model Extraction") {
+    ipasir2_errorcode ret;
+
+    void* solver;
+    ret = ipasir2_init(&solver);
+    CHECK(ret == IPASIR2_E_OK);
+
+    int result;
+    ret = ipasir2_add_formula(solver, {{ 1, 2 }, { -1, 3 }, { -2, -3 }, { 4 }, { -5, -4 }, { 1, 2, 3, 4, 5, 6 }});
+    CHECK(ret == IPASIR2_E_OK);
+
+    SUBCASE("Values in INPUT state") {
+        int8_t values[6];
+        ret = ipasir2_values != nullptr ? ipasir2_values(solver, 1, 6, values) : IPASIR2_E_UNSUPPORTED;
+        CHECK((ret == IPASIR2_E_INVALID_STATE || ret == IPASIR2_E_UNSUPPORTED));
+    }
+
+    SUBCASE("Values match ipasir2_value()") {
+        ret = ipasir2_solve(solver, &result, nullptr, 0);
+        CHECK(ret == IPASIR2_E_OK);
+        CHECK(result == RESULT_SAT);
+
+        int8_t values[6];
+        ret = ipasir2_values != nullptr ? ipasir2_values(solver, 1, 6, values) : IPASIR2_E_UNSUPPORTED;
+        if (ret == IPASIR2_E_UNSUPPORTED) {
+            MESSAGE("ipasir2_values() is not supported");
+        } else {
+            CHECK(ret == IPASIR2_E_OK);
+            for (int32_t var = 1; var <= 6; ++var) {
+                int32_t value;
+                ret = ipasir2_value(solver, var, &value);
+                CHECK(ret == IPASIR2_E_OK);
+                CHECK(values[var - 1] == (value > 0 ? 1 : (value < 0 ? -1 : 0)));
+            }
+        }
+    }
+
+    SUBCASE("Values of a variable range") {
+        ret = ipasir2_solve(solver, &result, nullptr, 0);
+        CHECK(ret == IPASIR2_E_OK);
+        CHECK(result == RESULT_SAT);
+
+        int8_t values[2];
+        ret = ipasir2_values != nullptr ? ipasir2_values(solver, 4, 2, values) : IPASIR2_E_UNSUPPORTED;
+        if (ret == IPASIR2_E_UNSUPPORTED) {
+            MESSAGE("ipasir2_values() is not supported");
+        } else {
+            CHECK(ret == IPASIR2_E_OK);
+            CHECK(values[0] == 1);
+            CHECK(values[1] == -1);
+        }
+    }
+
+    ret = ipasir2_release(solver);
+    CHECK(ret == IPASIR2_E_OK);
+}
+
+
+TEST_CASE("Clone") {
+    void* solver;
+    ipasir2_init(&solver);
+    // 4 pigeons in 4 holes: satisfiable, but solving needs search
+    auto var = [](int32_t pigeon, int32_t hole) { return pigeon * 4 + hole + 1; };
+    for (int32_t p = 0; p < 4; ++p) {
+        std::vector<int32_t> clause;
+        for (int32_t h = 0; h < 4; ++h) {
+            clause.push_back(var(p, h));
+            for (int32_t q = 0; q < p; ++q) {
+                int32_t conflict[2] = { -var(p, h), -var(q, h) };
+                ipasir2_add(solver, conflict, 2, 0, nullptr);
+            }
+        }
+        ipasir2_add(solver, clause.data(), clause.size(), 0, nullptr);
+    }
+
+    void* clone = nullptr;
+    // the subcases only run if the backend defines ipasir2_clone()
+    ipasir2_errorcode ret = ipasir2_clone != nullptr ? ipasir2_clone(solver, &clone) : IPASIR2_E_UNSUPPORTED;
+    if (ret == IPASIR2_E_UNSUPPORTED) {
+        ipasir2_release(solver);
+        return;
+    }
+    REQUIRE(ret == IPASIR2_E_OK);
+    int result;
+
+    SUBCASE("Clones have the same formula") {
+        int32_t assumptions[4] = { var(0, 0), var(1, 1), var(2, 2), var(3, 0) };
+        CHECK(ipasir2_solve(solver, &result, assumptions, 4) == IPASIR2_E_OK);
+        CHECK(result == 20);
+        CHECK(ipasir2_solve(clone, &result, assumptions, 4) == IPASIR2_E_OK);
+        CHECK(result == 20);
+        CHECK(ipasir2_solve(clone, &result, assumptions, 3) == IPASIR2_E_OK);
+        CHECK(result == 10);
+    }
+
+    SUBCASE("Clones are independent") {
+        // no hole left for pigeon 0 in the clone
+        for (int32_t h = 0; h < 4; ++h) {
+            int32_t unit = -var(0, h);
+            ipasir2_add(clone, &unit, 1, 0, nullptr);
+        }
+        void* second = nullptr;
+        REQUIRE(ipasir2_clone(clone, &second) == IPASIR2_E_OK);
+        CHECK(ipasir2_solve(clone, &result, nullptr, 0) == IPASIR2_E_OK);
+        CHECK(result == 20);
+        CHECK(ipasir2_solve(second, &result, nullptr, 0) == IPASIR2_E_OK);
+        CHECK(result == 20);
+        CHECK(ipasir2_solve(solver, &result, nullptr, 0) == IPASIR2_E_OK);
+        CHECK(result == 10);
+        ipasir2_release(second);
+    }
+
+    SUBCASE("Clones of solved instances are in INPUT state and can be solved concurrently") {
+        CHECK(ipasir2_solve(clone, &result, nullptr, 0) == IPASIR2_E_OK);
+        void* copies[2];
+        REQUIRE(ipasir2_clone(clone, &copies[0]) == IPASIR2_E_OK);
+        REQUIRE(ipasir2_clone(clone, &copies[1]) == IPASIR2_E_OK);
+        int32_t value;
+        CHECK(ipasir2_value(copies[0], 1, &value) == IPASIR2_E_INVALID_STATE);
+        int results[2] = { 0, 0 };
+        std::thread other([&]() { ipasir2_solve(copies[1], &results[1], nullptr, 0); });
+        ipasir2_solve(copies[0], &results[0], nullptr, 0);
+        other.join();
+        CHECK(results[0] == 10);
+        CHECK(results[1] == 10);
+        ipasir2_release(copies[0]);
+        ipasir2_release(copies[1]);
+    }
+
+    SUBCASE("Callbacks are not copied") {
+        int polls = 0;
+        ipasir2_set_terminate(solver, &polls, [](void* data) {
+            ++*static_cast<int*>(data);
+            return 1;
+        });
+        void* copy = nullptr;
+        REQUIRE(ipasir2_clone(solver, &copy) == IPASIR2_E_OK);
+        CHECK(ipasir2_solve(copy, &result, nullptr, 0) == IPASIR2_E_OK);
+        CHECK(result == 10);
+        CHECK(polls == 0);
+        ipasir2_release(copy);
+    }
+
+    ipasir2_release(clone);
+    ipasir2_release(solver);
+}
+
+TEST_CASE("Clause Ring") {
+    SUBCASE("Readers skip their own clauses") {
+        clause_ring ring(8, 4);
+        clause_ring::reader a { 0 }, b { 1 };
+        int32_t clause[3] = { 1, -2, 3 };
+        CHECK(ring.push(0, clause, 3, nullptr));
+        int32_t buffer[4];
+        int32_t len;
+        ipasir2_clause_meta* meta;
+        CHECK(!ring.pop(a, buffer, len, meta));
+        CHECK(ring.pop(b, buffer, len, meta));
+        CHECK(len == 3);
+        CHECK(std::equal(clause, clause + 3, buffer));
+        CHECK(!ring.pop(b, buffer, len, meta));
+    }
+
+    SUBCASE("Overwritten clauses are counted as lost") {
+        clause_ring ring(4, 2);
+        clause_ring::reader r { 1 };
+        for (int32_t i = 1; i <= 10; ++i) {
+            CHECK(ring.push(0, &i, 1, nullptr));
+        }
+        int32_t buffer[2];
+        int32_t len;
+        ipasir2_clause_meta* meta;
+        std::vector<int32_t> received;
+        while (ring.pop(r, buffer, len, meta)) {
+            received.push_back(buffer[0]);
+        }
+        CHECK(received == std::vector<int32_t> { 7, 8, 9, 10 });
+        CHECK(r.lost == 6);
+    }
+
+    SUBCASE("Clause metadata is copied and filtered") {
+        clause_ring ring(8, 4);
+        ring.set_max_lbd(3);
+        clause_ring::reader r { 1 };
+        int32_t clause[3] = { 1, -2, 3 };
+        ipasir2_clause_meta meta { 42, 2, 1.5f, IPASIR2_R_EQUIVALENT, nullptr, 0 };
+        CHECK(ring.push(0, clause, 3, &meta));
+        meta.lbd = 4;
+        CHECK(!ring.push(0, clause, 3, &meta));
+        meta.lbd = 1;
+        meta.redundancy = IPASIR2_R_SATISFIABLE;
+        CHECK(!ring.push(0, clause, 3, &meta));
+        CHECK(ring.push(0, clause, 2, nullptr));
+
+        int32_t buffer[4];
+        int32_t len;
+        ipasir2_clause_meta* received;
+        REQUIRE(ring.pop(r, buffer, len, received));
+        REQUIRE(received != nullptr);
+        CHECK(received->id == 42);
+        CHECK(received->lbd == 2);
+        CHECK(received->activity == 1.5f);
+        CHECK(received->redundancy == IPASIR2_R_EQUIVALENT);
+        REQUIRE(ring.pop(r, buffer, len, received));
+        CHECK(len == 2);
+        CHECK(received == nullptr);
+    }
+
+    SUBCASE("Concurrent producers and readers see consistent clauses") {
+        int32_t const max_length = 8;
+        int32_t const per_producer = 20000;
+        clause_ring ring(256, max_length);
+        std::atomic<int> running { 4 };
+        std::atomic<bool> torn { false };
+        std::vector<std::thread> threads;
+        for (int32_t p = 0; p < 4; ++p) {
+            threads.emplace_back([&, p]() {
+                int32_t clause[max_length];
+                for (int32_t i = 1; i <= per_producer; ++i) {
+                    int32_t len = 2 + i % (max_length - 1);
+                    clause[0] = p + 1;
+                    clause[1] = i;
+                    for (int32_t j = 2; j < len; ++j) {
+                        clause[j] = (p + 1) * 100000 + i + j;
+                    }
+                    ring.push(p, clause, len, nullptr);
+                }
+                --running;
+            });
+        }
+        for (int32_t c = 0; c < 2; ++c) {
+            threads.emplace_back([&, c]() {
+                clause_ring::reader r { 4 + c };
+                int32_t buffer[max_length];
+                int32_t len;
+                ipasir2_clause_meta* meta;
+                while (true) {
+                    bool done = running == 0;
+                    while (ring.pop(r, buffer, len, meta)) {
+                        bool consistent = len == 2 + buffer[1] % (max_length - 1);
+                        for (int32_t j = 2; consistent && j < len; ++j) {
+                            consistent = buffer[j] == buffer[0] * 100000 + buffer[1] + j;
+                        }
+                        if (!consistent) {
+                            torn = true;
+                        }
+                    }
+                    if (done) break;
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        CHECK(!torn);
+        CHECK(ring.pushed() == 4 * per_producer);
+    }
+}
+
+TEST_CASE("Clause Filter") {
+    SUBCASE("Duplicates are rejected independently of literal order") {
+        clause_filter filter(1024, 4);
+        int32_t clause[3] = { 1, -2, 3 };
+        int32_t permuted[3] = { 3, 1, -2 };
+        int32_t other[3] = { 1, 2, 3 };
+        CHECK(filter.insert(clause, 3));
+        CHECK(!filter.insert(permuted, 3));
+        CHECK(filter.insert(other, 3));
+        CHECK(!filter.insert(other, 3));
+        CHECK(filter.insert(clause, 2));
+        clause_filter::stats stats = filter.statistics();
+        CHECK(stats.checked == 5);
+        CHECK(stats.rejected == 2);
+    }
+
+    SUBCASE("Entries age out after max_age epochs") {
+        clause_filter filter(1024, 4, 2);
+        int32_t clause[2] = { 4, -5 };
+        CHECK(filter.insert(clause, 2));
+        filter.advance_epoch();
+        filter.advance_epoch();
+        CHECK(!filter.insert(clause, 2));
+        filter.advance_epoch();
+        CHECK(filter.insert(clause, 2));
+        CHECK(!filter.insert(clause, 2));
+    }
+
+    SUBCASE("Exported duplicates are not pushed to the ring") {
+        clause_ring ring(16, 4);
+        clause_filter filter(1024, 4);
+        clause_ring::endpoint a, b;
+        a.ring = b.ring = &ring;
+        a.position.id = 0;
+        b.position.id = 1;
+        a.filter = b.filter = &filter;
+        int32_t clause[2] = { 1, 2 };
+        int32_t permuted[2] = { 2, 1 };
+        clause_ring::export_callback(&a, clause, 2, nullptr);
+        clause_ring::export_callback(&b, permuted, 2, nullptr);
+        int32_t literals[4] = { 2, 1, 3, 4 };
+        int32_t offsets[3] = { 0, 2, 4 };
+        clause_ring::export_batch_callback(&b, literals, offsets, 2, nullptr);
+        CHECK(ring.pushed() == 2);
+        CHECK(a.exported == 1);
+        CHECK(b.exported == 1);
+        CHECK(b.filtered == 2);
+    }
+}
+
+TEST_CASE("C++ Wrapper") {
+    ipasir2::solver solver;
+
+    SUBCASE("Clauses, assumptions and models") {
+        std::vector<int32_t> clause { 1, 2 };
+        solver.add(clause);
+        solver.add({ -1, 2 });
+        int32_t assumptions[] = { -2 };
+        CHECK(solver.solve(assumptions) == ipasir2::result::unsat);
+        CHECK(solver.failed(-2));
+        CHECK(solver.core(assumptions) == std::vector<int32_t> { -2 });
+        CHECK(solver.solve() == ipasir2::result::sat);
+        CHECK(solver.value(2) == 2);
+    }
+
+    SUBCASE("Errors are thrown as exceptions") {
+        solver.add({ 1 });
+        try {
+            solver.value(1);
+            FAIL("no exception thrown");
+        }
+        catch (ipasir2::error const& e) {
+            CHECK(e.code() == IPASIR2_E_INVALID_STATE);
+        }
+    }
+
+    SUBCASE("Clones are owned by the wrapper") {
+        solver.add({ 1, 2 });
+        try {
+            ipasir2::solver copy = solver.clone();
+            copy.add({ -2 });
+            CHECK(copy.solve({ -1 }) == ipasir2::result::unsat);
+            CHECK(solver.solve({ -1 }) == ipasir2::result::sat);
+        }
+        catch (ipasir2::error const& e) {
+            CHECK(e.code() == IPASIR2_E_UNSUPPORTED);
+        }
+    }
+
+    SUBCASE("Functors are called through the callback trampolines") {
+        int polls = 0;
+        auto terminate = [&polls]() { return ++polls > 0; };
+        try {
+            solver.set_terminate(terminate);
+        }
+        catch (ipasir2::error const& e) {
+            CHECK(e.code() == IPASIR2_E_UNSUPPORTED);
+            return;
+        }
+        // pigeonhole formula with 6 pigeons and 5 holes, which needs search
+        auto var = [](int32_t pigeon, int32_t hole) { return pigeon * 5 + hole + 1; };
+        for (int32_t p = 0; p < 6; ++p) {
+            std::vector<int32_t> clause;
+            for (int32_t h = 0; h < 5; ++h) {
+                clause.push_back(var(p, h));
+                for (int32_t q = 0; q < p; ++q) {
+                    solver.add({ -var(p, h), -var(q, h) });
+                }
+            }
+            solver.add(clause);
+        }
+        CHECK(solver.solve() == ipasir2::result::unknown);
+        CHECK(polls > 0);
+    }
+    SUBCASE("Const functors can be bound") {
+        std::vector<int32_t> fixed;
+        auto const never = []() { return false; };
+        auto const collect = [&fixed](int32_t lit) { fixed.push_back(lit); };
+        try {
+            solver.set_terminate(never);
+            solver.set_fixed(collect);
+        }
+        catch (ipasir2::error const& e) {
+            CHECK(e.code() == IPASIR2_E_UNSUPPORTED);
+            return;
+        }
+        solver.add({ 1 });
+        CHECK(solver.solve() == ipasir2::result::sat);
+        CHECK(std::find(fixed.begin(), fixed.end(), 1) != fixed.end());
+    }
+}
+
+TEST_CASE("Async Solve") {
+    ipasir2::thread_pool pool(2);
+
+    // pigeonhole formula with 11 pigeons and 10 holes, which keeps the solver busy until cancelled
+    auto add_pigeonhole = [](ipasir2::solver& solver) {
+        auto var = [](int32_t pigeon, int32_t hole) { return pigeon * 10 + hole + 1; };
+        for (int32_t p = 0; p < 11; ++p) {
+            std::vector<int32_t> clause;
+            for (int32_t h = 0; h < 10; ++h) {
+                clause.push_back(var(p, h));
+                for (int32_t q = 0; q < p; ++q) {
+                    solver.add({ -var(p, h), -var(q, h) });
+                }
+            }
+            solver.add(clause);
+        }
+    };
+
+    // the pigeonhole formula can only be used if solve calls can be cancelled
+    auto supports_terminate = []() {
+        void* probe;
+        ipasir2_init(&probe);
+        ipasir2_errorcode ret = ipasir2_set_terminate(probe, nullptr, nullptr);
+        ipasir2_release(probe);
+        return ret != IPASIR2_E_UNSUPPORTED;
+    };
+
+    SUBCASE("Results are delivered through futures") {
+        std::vector<std::unique_ptr<ipasir2::async_solver>> solvers;
+        std::vector<ipasir2::solve_future> futures;
+        std::atomic<int> done { 0 };
+        for (int32_t i = 0; i < 4; ++i) {
+            solvers.emplace_back(new ipasir2::async_solver(pool));
+            solvers.back()->get().add({ 1, 2 });
+            solvers.back()->get().add({ -1, 2 });
+            futures.push_back(solvers.back()->solve({ i % 2 == 0 ? -2 : 2 }, [&done](ipasir2::result) { ++done; }));
+        }
+        for (int32_t i = 0; i < 4; ++i) {
+            CHECK(futures[i].get() == (i % 2 == 0 ? ipasir2::result::unsat : ipasir2::result::sat));
+        }
+        CHECK(done == 4);
+        CHECK(solvers[1]->get().value(2) == 2);
+        CHECK(solvers[0]->get().failed(-2));
+    }
+
+    SUBCASE("Only one solve call is pending per instance") {
+        if (!supports_terminate()) {
+            return;
+        }
+        ipasir2::async_solver solver(pool);
+        add_pigeonhole(solver.get());
+        ipasir2::solve_future future = solver.solve();
+        try {
+            solver.solve();
+            FAIL("no exception thrown");
+        }
+        catch (ipasir2::error const& e) {
+            CHECK(e.code() == IPASIR2_E_INVALID_STATE);
+        }
+        future.cancel();
+        future.wait();
+    }
+
+    SUBCASE("Cancelled solve calls complete with unknown") {
+        if (!supports_terminate()) {
+            return;
+        }
+        ipasir2::async_solver solver(pool);
+        add_pigeonhole(solver.get());
+        ipasir2::solve_future future = solver.solve();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        future.cancel();
+        CHECK(future.get() == ipasir2::result::unknown);
+        CHECK(solver.solve({ 1 }).valid());
+    }
+}
+
+TEST_CASE("Solver Pool") {
+    SUBCASE("Acquired instances are fresh") {
+        ipasir2::solver_pool pool(ipasir2::config(), 2);
+        {
+            ipasir2::pooled_solver solver = pool.acquire();
+            solver->add({ 1 });
+            solver->add({ -1 });
+            CHECK(solver->solve() == ipasir2::result::unsat);
+        }
+        for (int i = 0; i < 4; ++i) {
+            ipasir2::pooled_solver solver = pool.acquire();
+            solver->add({ 1, 2 });
+            CHECK(solver->solve({ -1 }) == ipasir2::result::sat);
+            CHECK(solver->value(2) == 2);
+        }
+        ipasir2::solver_pool::stats stats = pool.statistics();
+        CHECK(stats.pooled + stats.cold == 5);
+        CHECK(stats.pooled >= 1);
+    }
+
+    SUBCASE("Configuration errors are thrown by the constructor") {
+        try {
+            ipasir2::solver_pool pool(ipasir2::config().set("ipasir.no.such.option", 1));
+            FAIL("no exception thrown");
+        }
+        catch (ipasir2::error const& e) {
+            CHECK((e.code() == IPASIR2_E_UNSUPPORTED_OPTION || e.code() == IPASIR2_E_UNSUPPORTED));
+        }
+    }
+}
+
+TEST_CASE("Backend Loader") {
+    SUBCASE("Missing libraries are reported") {
+        CHECK_THROWS_AS(backend_library("ipasir2-no-such-backend.so"), std::runtime_error);
+    }
+
+    // set IPASIR2_TEST_BACKEND to the shared library of a backend to run this
+    char const* path = getenv("IPASIR2_TEST_BACKEND");
+    if (path == nullptr) {
+        return;
+    }
+
+    SUBCASE("Loaded backends are called through the function table") {
+        backend_library library(path);
+        void* solver;
+        REQUIRE(library.init(&solver) == IPASIR2_E_OK);
+        int32_t clause[2] = { 1, 2 };
+        int32_t assumptions[2] = { -1, -2 };
+        int result;
+        CHECK(library.add(solver, clause, 2, 0, nullptr) == IPASIR2_E_OK);
+        CHECK(library.solve(solver, &result, assumptions, 2) == IPASIR2_E_OK);
+        CHECK(result == 20);
+        CHECK(library.solve(solver, &result, assumptions, 1) == IPASIR2_E_OK);
+        CHECK(result == 10);
+        int32_t value = 0;
+        ipasir2_errorcode ret = library.value(solver, 2, &value);
+        CHECK((ret == IPASIR2_E_UNSUPPORTED || value == 2));
+        CHECK(library.release(solver) == IPASIR2_E_OK);
+    }
+}
+
+TEST_CASE("Batch Queries") {
+    auto load = [](ipasir2::solver& solver) {
+        solver.add({ -1, -2 });
+        solver.add({ -3, -4 });
+        solver.add({ 5, 6 });
+    };
+    ipasir2::batch_solver batch(3, load);
+    CHECK(batch.replicas() == 3);
+
+    std::vector<std::vector<int32_t>> queries {
+        { 1, 2 }, { 1, 3 }, { 3, 4, 1 }, {}, { -5, -6 }, { 1, 3, 5 }, { 1, 2 }, { 2, 4, -6 }
+    };
+    for (int32_t i = 0; i < 64; ++i) {
+        queries.push_back({ 1 + i % 4, 1 + (i / 4) % 4 });
+    }
+
+    SUBCASE("Results and cores are returned in submission order") {
+        std::vector<ipasir2::query_result> results = batch.solve(queries);
+        REQUIRE(results.size() == queries.size());
+        ipasir2::solver reference;
+        load(reference);
+        for (size_t i = 0; i < queries.size(); ++i) {
+            ipasir2::result expected = reference.solve(queries[i]);
+            CHECK(results[i].res == expected);
+            if (expected == ipasir2::result::unsat) {
+                std::vector<int32_t> core = results[i].core;
+                CHECK(!core.empty());
+                for (int32_t lit : core) {
+                    CHECK(std::find(queries[i].begin(), queries[i].end(), lit) != queries[i].end());
+                }
+            }
+        }
+        CHECK(results[0].res == ipasir2::result::unsat);
+        CHECK(results[3].res == ipasir2::result::sat);
+        CHECK(results[4].core.size() == 2);
+    }
+
+    SUBCASE("Replicas can be reused for further batches") {
+        batch.solve(queries, false);
+        std::vector<ipasir2::query_result> results = batch.solve({ { 3, 4 } });
+        REQUIRE(results.size() == 1);
+        CHECK(results[0].res == ipasir2::result::unsat);
+    }
+}
+
+TEST_CASE("Proof Writer") {
+    char const* path = "ipasir2_test_proof.bin";
+    auto read = [path]() {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    };
+
+    SUBCASE("Binary DRAT encoding") {
+        proof_writer proof(path, proof_writer::DRAT);
+        int32_t clause[2] = { 1, -100 };
+        proof.learned(clause, 2, nullptr);
+        proof.deleted(clause, 2, nullptr);
+        proof.conclude();
+        CHECK(proof.close());
+        std::vector<uint8_t> expected { 'a', 2, 201, 1, 0, 'd', 2, 201, 1, 0, 'a', 0 };
+        CHECK(read() == expected);
+        CHECK(proof.statistics().bytes == expected.size());
+    }
+
+    SUBCASE("Binary LRAT encoding") {
+        proof_writer proof(path, proof_writer::LRAT);
+        int32_t clause[2] = { 1, -2 };
+        int64_t hints[3] = { 3, 1, -2 };
+        ipasir2_clause_meta meta {};
+        meta.id = 5;
+        proof.learned(clause, 2, &meta);
+        meta.hints = hints;
+        meta.hints_count = 3;
+        proof.learned(clause, 2, &meta);
+        proof.deleted(clause, 2, &meta);
+        proof.conclude();
+        CHECK(proof.close());
+        std::vector<uint8_t> expected { 'a', 10, 2, 5, 0, 6, 2, 5, 0, 'd', 10, 0 };
+        CHECK(read() == expected);
+        CHECK(proof.statistics().learned == 1);
+        CHECK(proof.statistics().incomplete == 1);
+    }
+
+    SUBCASE("Steps are kept in order across buffer swaps") {
+        std::vector<uint8_t> expected;
+        {
+            proof_writer proof(path, proof_writer::DRAT, 16);
+            for (int32_t i = 1; i <= 1000; ++i) {
+                int32_t clause[1] = { i % 60 + 1 };
+                proof.learned(clause, 1, nullptr);
+                expected.insert(expected.end(), { 'a', static_cast<uint8_t>(2 * clause[0]), 0 });
+            }
+        }
+        CHECK(read() == expected);
+    }
+
+    SUBCASE("Learned clauses of an attached solver are recorded") {
+        void* solver;
+        REQUIRE(ipasir2_init(&solver) == IPASIR2_E_OK);
+        proof_writer proof(path, proof_writer::DRAT);
+        ipasir2_errorcode ret = proof.attach(solver);
+        if (ret == IPASIR2_E_OK) {
+            // pigeonhole formula with 5 pigeons and 4 holes, in the layout of ipasir2_add_clauses()
+            auto var = [](int32_t pigeon, int32_t hole) { return pigeon * 4 + hole + 1; };
+            std::vector<std::vector<int32_t>> clauses;
+            for (int32_t p = 0; p < 5; ++p) {
+                std::vector<int32_t> clause;
+                for (int32_t h = 0; h < 4; ++h) {
+                    clause.push_back(var(p, h));
+                    for (int32_t q = 0; q < p; ++q) {
+                        clauses.push_back({ -var(p, h), -var(q, h) });
+                    }
+                }
+                clauses.push_back(clause);
+            }
+            std::vector<int32_t> literals;
+            std::vector<int32_t> offsets { 0 };
+            for (std::vector<int32_t> const& clause : clauses) {
+                literals.insert(literals.end(), clause.begin(), clause.end());
+                offsets.push_back(literals.size());
+            }
+            CHECK(proof.add_clauses(solver, literals.data(), offsets.data(), clauses.size()) == IPASIR2_E_OK);
+            int result;
+            CHECK(ipasir2_solve(solver, &result, nullptr, 0) == IPASIR2_E_OK);
+            CHECK(result == 20);
+            CHECK(proof.close());
+            CHECK(proof.statistics().added == clauses.size());
+            CHECK(proof.statistics().learned > 0);
+            CHECK(read().size() == proof.statistics().bytes);
+        }
+        else {
+            CHECK(ret == IPASIR2_E_UNSUPPORTED);
+        }
+        ipasir2_release(solver);
+    }
+
+    remove(path);
+}
+
+TEST_CASE("MUS Extraction") {
+    // satisfiability of the clauses of f with the given indices
+    auto solve_subset = [](mus_formula const& f, std::vector<int32_t> const& clauses) {
+        void* solver;
+        ipasir2_init(&solver);
+        for (int32_t c : clauses) {
+            ipasir2_add(solver, f.literals.data() + f.offsets[c], f.offsets[c + 1] - f.offsets[c], 0, nullptr);
+        }
+        int result = 0;
+        ipasir2_solve(solver, &result, nullptr, 0);
+        ipasir2_release(solver);
+        return result;
+    };
+
+    SUBCASE("Refinement during a check") {
+        // (x1) (-x1) (x2) (-x2): worker A checks clause 0 while worker B refines to {2, 3}
+        mus_formula f;
+        f.max_var = 2;
+        for (int32_t lit : { 1, -1, 2, -2 }) {
+            f.literals.push_back(lit);
+            f.offsets.push_back(f.literals.size());
+        }
+        mus_state state(f, { 0, 1, 2, 3 }, 1);
+        std::atomic<bool> stop(false);
+        std::vector<int32_t> assumptions;
+        int64_t budget;
+        CHECK(state.take(assumptions, budget, stop) == 0);
+        CHECK(state.take(assumptions, budget, stop) == 1);
+        CHECK(state.refine(1, { state.selector(2), state.selector(3) }));
+        std::vector<int8_t> model = { -1, 1 };
+        state.critical(0, model);
+        CHECK(state.current() == std::vector<int32_t>({ 2, 3 }));
+    }
+
+    SUBCASE("Concurrent workers find a minimal subset") {
+        int32_t const threads = 4;
+        for (uint32_t seed = 1; seed <= 20; ++seed) {
+            // random 3-CNF far above the threshold, unsatisfiable with many overlapping cores
+            std::mt19937 rng(seed);
+            mus_formula f;
+            f.max_var = 10;
+            for (int32_t i = 0; i < 80; ++i) {
+                for (int32_t j = 0; j < 3; ++j) {
+                    int32_t var = 1 + rng() % f.max_var;
+                    f.literals.push_back(rng() % 2 ? var : -var);
+                }
+                f.offsets.push_back(f.literals.size());
+            }
+            mus_formula selected;
+            selected.max_var = f.max_var + f.size();
+            std::vector<int32_t> assumptions;
+            for (int32_t i = 0; i < f.size(); ++i) {
+                selected.literals.insert(selected.literals.end(), f.literals.begin() + f.offsets[i], f.literals.begin() + f.offsets[i + 1]);
+                selected.literals.push_back(-(f.max_var + 1 + i));
+                selected.offsets.push_back(selected.literals.size());
+                assumptions.push_back(f.max_var + 1 + i);
+            }
+
+            std::vector<mus_worker> workers(threads);
+            for (mus_worker& w : workers) {
+                REQUIRE(ipasir2_init(&w.solver) == IPASIR2_E_OK);
+                REQUIRE(ipasir2_add_formula(w.solver, selected.literals.data(), selected.offsets.data(), selected.size()) == IPASIR2_E_OK);
+            }
+            int result = 0;
+            REQUIRE(ipasir2_solve(workers[0].solver, &result, assumptions.data(), assumptions.size()) == IPASIR2_E_OK);
+            if (result != RESULT_UNSAT) {
+                for (mus_worker& w : workers) {
+                    ipasir2_release(w.solver);
+                }
+                continue;
+            }
+            std::vector<int32_t> core;
+            REQUIRE(ipasir2_core(workers[0].solver, assumptions.data(), assumptions.size(), core) == IPASIR2_E_OK);
+            for (int32_t& lit : core) {
+                lit -= f.max_var + 1;
+            }
+
+            // a budget of one conflict postpones many checks, which mixes the order of the results
+            mus_state state(f, core, 1);
+            mus_deadline limit;
+            std::vector<std::thread> pool;
+            for (mus_worker& w : workers) {
+                pool.emplace_back([&]() { w.err = mus_shrink(w, state, f, limit); });
+            }
+            for (std::thread& t : pool) {
+                t.join();
+            }
+            for (mus_worker& w : workers) {
+                CHECK(w.err == IPASIR2_E_OK);
+                ipasir2_release(w.solver);
+            }
+
+            CHECK(state.minimal());
+            std::vector<int32_t> mus = state.current();
+            CHECK(solve_subset(f, mus) == RESULT_UNSAT);
+            for (size_t i = 0; i < mus.size(); ++i) {
+                std::vector<int32_t> rest = mus;
+                rest.erase(rest.begin() + i);
+                CHECK(solve_subset(f, rest) == RESULT_SAT);
+            }
+        }
+    }
+}
@@ -0,0 +1,215 @@
+/**
+ * MIT License
+ *
+ * Binary DRAT / LRAT proof sink for IPASIR-2 solvers, see proof_writer.h.
+ *
+ */
+
+#include "proof_writer.h"
+#include "ipasir2_optional.h"
+
+#include <string.h>
+#include <stdexcept>
+
+
+proof_writer::proof_writer(std::string const& path, format fmt, size_t buffer_size)
+    : m_format(fmt), m_capacity(buffer_size > 0 ? buffer_size : 1) {
+    m_file = fopen(path.c_str(), "wb");
+    if (m_file == nullptr) {
+        throw std::runtime_error("Cannot open proof file " + path);
+    }
+    // the buffers are written in large blocks, stdio buffering would only copy them once more
+    setvbuf(m_file, nullptr, _IONBF, 0);
+    m_front.reserve(m_capacity + 64);
+    m_back.reserve(m_capacity + 64);
+    m_worker = std::thread([this]() { run(); });
+}
+
+proof_writer::~proof_writer() {
+    close();
+}
+
+ipasir2_errorcode proof_writer::attach(void* solver) {
+    ipasir2_option const* options = nullptr;
+    int count = 0;
+    ipasir2_errorcode err = ipasir2_options(solver, &options, &count);
+    m_clause_meta = false;
+    for (int i = 0; err == IPASIR2_E_OK && i < count; ++i) {
+        if (strcmp(options[i].name, "ipasir.proofmeta.clause") == 0) {
+            m_clause_meta = ipasir2_set_option(solver, &options[i], 1, 0) == IPASIR2_E_OK;
+        }
+    }
+    if (m_format == LRAT && !m_clause_meta) {
+        return IPASIR2_E_UNSUPPORTED;
+    }
+    err = ipasir2_set_export(solver, this, -1, export_callback);
+    if (err) {
+        return err;
+    }
+    // without deletions the proof is still valid, only slower to check
+    err = ipasir2_set_delete(solver, this, delete_callback);
+    return err == IPASIR2_E_UNSUPPORTED ? IPASIR2_E_OK : err;
+}
+
+ipasir2_errorcode proof_writer::add(void* solver, int32_t const* clause, int32_t len) {
+    ipasir2_clause_meta meta {};
+    meta.id = ++m_next_id;
+    meta.redundancy = IPASIR2_R_EQUIVALENT;
+    ++m_stats.added;
+    return ipasir2_add(solver, clause, len, 0, m_clause_meta ? &meta : nullptr);
+}
+
+ipasir2_errorcode proof_writer::add_clauses(void* solver, int32_t const* literals, int32_t const* offsets, int32_t count) {
+    std::vector<ipasir2_clause_meta> metas(count);
+    std::vector<void*> pointers(count);
+    for (int32_t i = 0; i < count; ++i) {
+        metas[i].id = m_next_id + 1 + i;
+        metas[i].redundancy = IPASIR2_R_EQUIVALENT;
+        pointers[i] = &metas[i];
+    }
+    ipasir2_errorcode err = IPASIR2_E_UNSUPPORTED;
+    if (ipasir2_add_clauses != nullptr) {
+        err = ipasir2_add_clauses(solver, literals, offsets, count, 0, m_clause_meta ? pointers.data() : nullptr);
+    }
+    if (err == IPASIR2_E_OK) {
+        m_next_id += count;
+        m_stats.added += count;
+        return err;
+    }
+    if (err != IPASIR2_E_UNSUPPORTED) {
+        return err;
+    }
+    for (int32_t i = 0; i < count; ++i) {
+        err = add(solver, literals + offsets[i], offsets[i + 1] - offsets[i]);
+        if (err) {
+            return err;
+        }
+    }
+    return IPASIR2_E_OK;
+}
+
+void proof_writer::learned(int32_t const* clause, int32_t len, ipasir2_clause_meta const* meta) {
+    if (m_format == DRAT) {
+        m_front.push_back('a');
+        put_clause(clause, len);
+    }
+    else {
+        if (meta == nullptr || meta->id == 0 || meta->hints == nullptr) {
+            ++m_stats.incomplete;
+            return;
+        }
+        m_front.push_back('a');
+        put(2 * meta->id);
+        put_clause(clause, len);
+        for (int32_t i = 0; i < meta->hints_count; ++i) {
+            put_literal(meta->hints[i]);
+        }
+        put(0);
+    }
+    ++m_stats.learned;
+    step_done();
+}
+
+void proof_writer::deleted(int32_t const* clause, int32_t len, ipasir2_clause_meta const* meta) {
+    if (m_format == DRAT) {
+        m_front.push_back('d');
+        put_clause(clause, len);
+    }
+    else {
+        // a missing deletion does not invalidate the proof
+        if (meta == nullptr || meta->id == 0) {
+            return;
+        }
+        m_front.push_back('d');
+        put(2 * meta->id);
+        put(0);
+    }
+    ++m_stats.deleted;
+    step_done();
+}
+
+void proof_writer::conclude() {
+    if (m_format == DRAT) {
+        learned(nullptr, 0, nullptr);
+    }
+}
+
+bool proof_writer::close() {
+    if (m_file == nullptr) {
+        return !m_failed;
+    }
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_written.wait(lock, [this]() { return !m_writing; });
+    }
+    if (!m_front.empty()) {
+        swap();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wakeup.notify_one();
+    m_worker.join();
+    if (fclose(m_file) != 0) {
+        m_failed = true;
+    }
+    m_file = nullptr;
+    return !m_failed;
+}
+
+proof_writer::stats proof_writer::statistics() const {
+    stats result = m_stats;
+    result.bytes = m_bytes.load(std::memory_order_relaxed);
+    return result;
+}
+
+void proof_writer::export_callback(void* data, int32_t const* clause, int32_t len, void* proofmeta) {
+    proof_writer* writer = static_cast<proof_writer*>(data);
+    writer->learned(clause, len, writer->m_clause_meta ? static_cast<ipasir2_clause_meta const*>(proofmeta) : nullptr);
+}
+
+void proof_writer::delete_callback(void* data, int32_t const* clause, int32_t len, void* proofmeta) {
+    proof_writer* writer = static_cast<proof_writer*>(data);
+    writer->deleted(clause, len, writer->m_clause_meta ? static_cast<ipasir2_clause_meta const*>(proofmeta) : nullptr);
+}
+
+// Called by the solving thread, which owns m_front. m_back belongs to the background thread while m_writing is set.
+void proof_writer::swap() {
+    if (m_writing.load(std::memory_order_acquire)) {
+        // keep filling the front buffer rather than waiting for the disk
+        if (!m_delayed) {
+            m_delayed = true;
+            ++m_stats.delayed;
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::swap(m_front, m_back);
+        m_writing.store(true, std::memory_order_release);
+    }
+    m_wakeup.notify_one();
+    m_front.clear();
+    m_delayed = false;
+}
+
+void proof_writer::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wakeup.wait(lock, [this]() { return m_stop || m_writing; });
+        if (!m_writing) {
+            return;
+        }
+        lock.unlock();
+        size_t written = fwrite(m_back.data(), 1, m_back.size(), m_file);
+        if (written != m_back.size()) {
+            m_failed = true;
+        }
+        m_bytes.fetch_add(written, std::memory_order_relaxed);
+        m_back.clear();
+        lock.lock();
+        m_writing.store(false, std::memory_order_release);
+        m_written.notify_all();
+    }
+}
@@ -0,0 +1,157 @@
+/**
+ * MIT License
+ *
+ * Proof sink: writes the clauses learned and deleted by an IPASIR-2 solver into a binary DRAT or
+ * binary LRAT proof, as accepted by drat-trim and lrat-trim.
+ *
+ * attach() registers the writer as export callback for all learned clauses (ipasir2_set_export()
+ * with max_length -1) and as delete callback, and enables the standard clause metadata (option
+ * ipasir.proofmeta.clause). In DRAT, each step carries the literals of the clause. In LRAT, it carries
+ * the clause ID and the hints of ipasir2_clause_meta, and the input clauses must be added through
+ * add() or add_clauses(), which number them from 1 in the order of the formula and pass the IDs to
+ * the solver. Learned clauses without ID or hints cannot be written in LRAT and are counted as
+ * incomplete; the proof is then rejected by the checker.
+ *
+ * The proof is only complete if the solver exports every clause it derives, including the empty
+ * clause. For solvers which stop at a conflict without exporting it, conclude() adds the empty
+ * clause in DRAT after an unsatisfiable solve call without assumptions.
+ *
+ * Steps are encoded into a buffer on the calling (solving) thread. When the buffer is full, it is
+ * swapped with a second one written to the file by a background thread, so the solver does not
+ * wait for the disk. If the background thread is still busy, the buffer grows instead.
+ * A writer serves one solver instance, its methods must not be called concurrently.
+ *
+ * Example:
+ *
+ *     proof_writer proof("proof.lrat", proof_writer::LRAT);
+ *     proof.attach(solver);
+ *     proof.add_clauses(solver, literals, offsets, count);
+ *     ipasir2_solve(solver, &result, nullptr, 0);
+ *     proof.close();
+ *
+ */
+
+#ifndef IPASIR2_PROOF_WRITER_H
+#define IPASIR2_PROOF_WRITER_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ipasir2.h"
+
+
+class proof_writer {
+public:
+    enum format { DRAT, LRAT };
+
+    struct stats {
+        uint64_t added = 0;         // input clauses numbered by add() and add_clauses()
+        uint64_t learned = 0;       // learned clauses written
+        uint64_t deleted = 0;       // deletions written
+        uint64_t incomplete = 0;    // learned clauses dropped for missing ID or hints (LRAT)
+        uint64_t delayed = 0;       // full buffers which had to grow since the file was still being written
+        uint64_t bytes = 0;         // bytes written to the file
+    };
+
+    /**
+     * Opens \p path for writing, throws std::runtime_error if it cannot be opened.
+     * \p buffer_size is the size of each of the two buffers in bytes.
+     */
+    proof_writer(std::string const& path, format fmt = DRAT, size_t buffer_size = 1 << 20);
+
+    // closes the proof, see close()
+    ~proof_writer();
+
+    proof_writer(proof_writer const&) = delete;
+    proof_writer& operator=(proof_writer const&) = delete;
+
+    /**
+     * Sets the export and delete callbacks of \p solver and enables ipasir.proofmeta.clause, so it
+     * must be called in the CONFIG state. Returns IPASIR2_E_UNSUPPORTED if the solver does not export
+     * clauses, or, for LRAT, does not support the clause metadata.
+     */
+    ipasir2_errorcode attach(void* solver);
+
+    // adds an input clause to \p solver with the next clause ID as metadata
+    ipasir2_errorcode add(void* solver, int32_t const* clause, int32_t len);
+
+    // adds input clauses to \p solver with consecutive clause IDs, see ipasir2_add_clauses()
+    ipasir2_errorcode add_clauses(void* solver, int32_t const* literals, int32_t const* offsets, int32_t count);
+
+    // records a learned clause, \p meta may be nullptr
+    void learned(int32_t const* clause, int32_t len, ipasir2_clause_meta const* meta);
+
+    // records a deleted clause, \p meta may be nullptr
+    void deleted(int32_t const* clause, int32_t len, ipasir2_clause_meta const* meta);
+
+    // adds the empty clause (DRAT only, LRAT requires its hints)
+    void conclude();
+
+    /**
+     * Writes the remaining steps and closes the file. Blocks until the background thread is done.
+     * Returns false if a write failed. Later calls have no effect.
+     */
+    bool close();
+
+    stats statistics() const;
+
+private:
+    static void export_callback(void* data, int32_t const* clause, int32_t len, void* proofmeta);
+    static void delete_callback(void* data, int32_t const* clause, int32_t len, void* proofmeta);
+
+    void put(uint64_t value) {
+        while (value > 0x7f) {
+            m_front.push_back(static_cast<uint8_t>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        m_front.push_back(static_cast<uint8_t>(value));
+    }
+
+    void put_literal(int64_t lit) {
+        put(lit < 0 ? 2 * static_cast<uint64_t>(-lit) + 1 : 2 * static_cast<uint64_t>(lit));
+    }
+
+    void put_clause(int32_t const* clause, int32_t len) {
+        for (int32_t i = 0; i < len; ++i) {
+            put_literal(clause[i]);
+        }
+        put(0);
+    }
+
+    // hands the buffer to the background thread once it is full
+    void step_done() {
+        if (m_front.size() >= m_capacity) {
+            swap();
+        }
+    }
+
+    void swap();
+    void run();
+
+    format m_format;
+    size_t m_capacity;
+    FILE* m_file = nullptr;
+    bool m_clause_meta = false;
+    uint64_t m_next_id = 0;
+    stats m_stats;
+
+    std::vector<uint8_t> m_front;        // filled by the solving thread
+    std::vector<uint8_t> m_back;         // written by the background thread while m_writing is set
+    std::atomic<bool> m_writing { false };
+    std::atomic<bool> m_failed { false };
+    std::atomic<uint64_t> m_bytes { 0 };
+    bool m_delayed = false;
+    bool m_stop = false;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    std::condition_variable m_written;
+    std::thread m_worker;
+};
+
+#endif // IPASIR2_PROOF_WRITER_H
@@ -0,0 +1,669 @@
+/**
+ * MIT License
+ *
+ * IPASIR-2 tracing shim: an IPASIR-2 implementation which records every call into a
+ * binary trace file (see trace_format.h) and forwards it to a real IPASIR-2 backend.
+ *
+ * The backend is resolved at the first call:
+ *  - If IPASIR2_TRACE_BACKEND is set, it names the shared library of the backend, which is dlopen()ed.
+ *  - Otherwise, the next definitions of the ipasir2_* symbols in the lookup order are used (RTLD_NEXT),
+ *    e.g., when running an application linked to a shared backend with LD_PRELOAD=libipasir2_trace.so.
+ *
+ * The trace is written to the file named by IPASIR2_TRACE_FILE (default: ipasir2.trace).
+ * Records are appended to a per-thread buffer without locking. Full buffers are handed to a
+ * background thread which writes them to the file, so the application threads never wait for I/O.
+ *
+ */
+
+#include "ipasir2.h"
+#include "trace_format.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <dlfcn.h>
+
+
+namespace {
+
+const size_t buffer_capacity = 1 << 20;
+
+uint64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+class backend {
+public:
+    decltype(&ipasir2_signature) signature = nullptr;
+    decltype(&ipasir2_init) init = nullptr;
+    decltype(&ipasir2_release) release = nullptr;
+    decltype(&ipasir2_clone) clone = nullptr;
+    decltype(&ipasir2_options) options = nullptr;
+    decltype(&ipasir2_set_option) set_option = nullptr;
+    decltype(&ipasir2_set_option_array) set_option_array = nullptr;
+    decltype(&ipasir2_add) add = nullptr;
+    decltype(&ipasir2_add_clauses) add_clauses = nullptr;
+    decltype(&ipasir2_solve) solve = nullptr;
+    decltype(&ipasir2_value) value = nullptr;
+    decltype(&ipasir2_values) values = nullptr;
+    decltype(&ipasir2_failed) failed = nullptr;
+    decltype(&ipasir2_failed_core) failed_core = nullptr;
+    decltype(&ipasir2_set_terminate) set_terminate = nullptr;
+    decltype(&ipasir2_set_export) set_export = nullptr;
+    decltype(&ipasir2_set_export_batch) set_export_batch = nullptr;
+    decltype(&ipasir2_set_delete) set_delete = nullptr;
+    decltype(&ipasir2_set_import) set_import = nullptr;
+    decltype(&ipasir2_set_fixed) set_fixed = nullptr;
+
+    backend() {
+        void* lib = RTLD_NEXT;
+        char const* path = getenv("IPASIR2_TRACE_BACKEND");
+        if (path != nullptr) {
+            int flags = RTLD_NOW | RTLD_LOCAL;
+#ifdef RTLD_DEEPBIND
+            // calls of the backend to its own ipasir2_* functions must not be recorded
+            flags |= RTLD_DEEPBIND;
+#endif
+            lib = dlopen(path, flags);
+            if (lib == nullptr) {
+                fprintf(stderr, "ipasir2_trace: cannot load backend %s: %s\n", path, dlerror());
+                abort();
+            }
+        }
+        resolve(lib, "ipasir2_signature", signature);
+        resolve(lib, "ipasir2_init", init);
+        resolve(lib, "ipasir2_release", release);
+        resolve(lib, "ipasir2_clone", clone);
+        resolve(lib, "ipasir2_options", options);
+        resolve(lib, "ipasir2_set_option", set_option);
+        resolve(lib, "ipasir2_set_option_array", set_option_array);
+        resolve(lib, "ipasir2_add", add);
+        resolve(lib, "ipasir2_add_clauses", add_clauses);
+        resolve(lib, "ipasir2_solve", solve);
+        resolve(lib, "ipasir2_value", value);
+        resolve(lib, "ipasir2_values", values);
+        resolve(lib, "ipasir2_failed", failed);
+        resolve(lib, "ipasir2_failed_core", failed_core);
+        resolve(lib, "ipasir2_set_terminate", set_terminate);
+        resolve(lib, "ipasir2_set_export", set_export);
+        resolve(lib, "ipasir2_set_export_batch", set_export_batch);
+        resolve(lib, "ipasir2_set_delete", set_delete);
+        resolve(lib, "ipasir2_set_import", set_import);
+        resolve(lib, "ipasir2_set_fixed", set_fixed);
+
+        if (signature == nullptr || init == nullptr || release == nullptr || add == nullptr || solve == nullptr) {
+            fprintf(stderr, "ipasir2_trace: no IPASIR-2 backend found, set IPASIR2_TRACE_BACKEND\n");
+            abort();
+        }
+    }
+
+private:
+    template<typename F>
+    static void resolve(void* lib, char const* name, F& fn) {
+        fn = reinterpret_cast<F>(dlsym(lib, name));
+    }
+};
+
+backend& real() {
+    static backend instance;
+    return instance;
+}
+
+// Calls the backend function if the backend provides it
+template<typename F, typename... Args>
+ipasir2_errorcode forward(F fn, Args... args) {
+    return fn != nullptr ? fn(args...) : IPASIR2_E_UNSUPPORTED;
+}
+
+
+class trace_writer {
+public:
+    trace_writer() {
+        char const* path = getenv("IPASIR2_TRACE_FILE");
+        m_file = fopen(path != nullptr ? path : "ipasir2.trace", "wb");
+        if (m_file == nullptr) {
+            fprintf(stderr, "ipasir2_trace: cannot open trace file, recording disabled\n");
+            return;
+        }
+        ipasir2_trace_file_header header;
+        memcpy(header.magic, IPASIR2_TRACE_MAGIC, sizeof(header.magic));
+        header.version = IPASIR2_TRACE_VERSION;
+        header.reserved = 0;
+        fwrite(&header, sizeof(header), 1, m_file);
+        m_worker = std::thread([this]() { run(); });
+    }
+
+    ~trace_writer() {
+        if (m_file == nullptr) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wakeup.notify_one();
+        m_worker.join();
+        fclose(m_file);
+    }
+
+    // Takes the content of data and leaves an empty buffer with unchanged capacity in its place
+    void submit(uint32_t thread, std::vector<char>& data) {
+        std::vector<char> empty;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_file != nullptr) {
+                m_queue.emplace_back(thread, std::move(data));
+            }
+            if (!m_free.empty()) {
+                empty = std::move(m_free.back());
+                m_free.pop_back();
+            }
+        }
+        m_wakeup.notify_one();
+        data = std::move(empty);
+        data.clear();
+        data.reserve(buffer_capacity);
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_wakeup.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+            if (m_queue.empty()) {
+                return;
+            }
+            std::pair<uint32_t, std::vector<char>> chunk = std::move(m_queue.front());
+            m_queue.pop_front();
+            lock.unlock();
+
+            ipasir2_trace_chunk_header header { IPASIR2_TRACE_CHUNK_MAGIC, chunk.first, chunk.second.size() };
+            fwrite(&header, sizeof(header), 1, m_file);
+            fwrite(chunk.second.data(), 1, chunk.second.size(), m_file);
+            chunk.second.clear();
+
+            lock.lock();
+            m_free.push_back(std::move(chunk.second));
+        }
+    }
+
+    FILE* m_file = nullptr;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    std::deque<std::pair<uint32_t, std::vector<char>>> m_queue;
+    std::vector<std::vector<char>> m_free;
+    std::thread m_worker;
+    bool m_stop = false;
+};
+
+trace_writer& writer() {
+    static trace_writer instance;
+    return instance;
+}
+
+
+class thread_buffer {
+public:
+    thread_buffer() : m_thread(next_thread++) {
+        writer();   // construct the writer first, so that it is destroyed after all thread buffers
+        m_data.resize(buffer_capacity);
+    }
+
+    ~thread_buffer() {
+        flush();
+    }
+
+    // copies into the buffer, which is kept at full size, so that appending is a bounds check and a memcpy
+    void append(void const* data, size_t size) {
+        if (m_size + size > m_data.size()) {
+            m_data.resize(m_size + size);
+        }
+        memcpy(m_data.data() + m_size, data, size);
+        m_size += size;
+    }
+
+    void record_done() {
+        if (m_size >= buffer_capacity) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (m_size > 0) {
+            m_data.resize(m_size);
+            writer().submit(m_thread, m_data);
+            m_data.resize(buffer_capacity);
+            m_size = 0;
+        }
+    }
+
+private:
+    static std::atomic<uint32_t> next_thread;
+    uint32_t m_thread;
+    std::vector<char> m_data;
+    size_t m_size = 0;
+};
+
+std::atomic<uint32_t> thread_buffer::next_thread { 0 };
+
+thread_local int callback_depth = 0;
+
+thread_buffer& buffer() {
+    thread_local thread_buffer instance;
+    return instance;
+}
+
+
+class record {
+public:
+    record(ipasir2_trace_function function, void* solver, ipasir2_errorcode error, uint64_t start, uint64_t end) : m_buffer(buffer()) {
+        header(function, solver, error, start, end - start);
+    }
+
+    // for cheap calls, where reading the clock twice would dominate the recording overhead, the duration is 0;
+    // \p start is still read before the call, so that the timestamps of all records mark the start of the call
+    record(ipasir2_trace_function function, void* solver, ipasir2_errorcode error, uint64_t start) : m_buffer(buffer()) {
+        header(function, solver, error, start, 0);
+    }
+
+    ~record() {
+        m_buffer.record_done();
+    }
+
+    template<typename T>
+    record& put(T const& value) {
+        m_buffer.append(&value, sizeof(value));
+        return *this;
+    }
+
+    template<typename T>
+    record& put(T const* values, int32_t count) {
+        if (values != nullptr && count > 0) {
+            m_buffer.append(values, sizeof(T) * count);
+        }
+        return *this;
+    }
+
+    record& put_string(char const* str) {
+        int32_t len = str != nullptr ? strlen(str) : 0;
+        put(len);
+        return put(str, len);
+    }
+
+private:
+    void header(ipasir2_trace_function function, void* solver, ipasir2_errorcode error, uint64_t timestamp, uint64_t duration) {
+        ipasir2_trace_record_header header;
+        header.function = function;
+        header.flags = callback_depth > 0 ? IPASIR2_TRACE_IN_CALLBACK : 0;
+        header.reserved = 0;
+        header.error = error;
+        header.timestamp = timestamp;
+        header.duration = duration;
+        header.solver = reinterpret_cast<uintptr_t>(solver);
+        put(header);
+    }
+
+    thread_buffer& m_buffer;
+};
+
+/**
+ * A callback registered by the application together with its data pointer.
+ * The pair is published as one immutable binding, so that a trampoline running on a solver thread
+ * never sees the callback of one registration with the data of another. Replaced bindings are kept
+ * until the solver is released, since a trampoline may still be reading them.
+ */
+template<typename F>
+class callback_slot {
+public:
+    struct binding {
+        void* data;
+        F callback;
+    };
+
+    // the current binding, or nullptr if no callback is set
+    binding const* load() const {
+        return m_current.load(std::memory_order_acquire);
+    }
+
+    void store(void* data, F callback) {
+        std::unique_ptr<binding> next(callback != nullptr ? new binding { data, callback } : nullptr);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_current.store(next.get(), std::memory_order_release);
+        if (next != nullptr) {
+            m_bindings.push_back(std::move(next));
+        }
+    }
+
+private:
+    std::atomic<binding const*> m_current { nullptr };
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<binding>> m_bindings;
+};
+
+/**
+ * Callbacks registered by the application for one solver instance.
+ * The shim registers its own trampolines with the backend, which record the callback and forward it.
+ * A binding is updated only after the backend accepted the registration, so a trampoline can run
+ * before its binding is set or after it is cleared, and then does nothing.
+ */
+struct traced_solver {
+    void* solver = nullptr;
+    uint64_t polls = 0;
+
+    callback_slot<int (*)(void* data)> terminate;
+    callback_slot<void (*)(void* data, int32_t const* clause, int32_t len, void* proofmeta)> export_clause;
+    callback_slot<void (*)(void* data, int32_t const* literals, int32_t const* offsets, int32_t count, void* const* proofmeta)> export_batch;
+    callback_slot<void (*)(void* data, int32_t const* clause, int32_t len, void* proofmeta)> delete_clause;
+    callback_slot<void (*)(void* data)> import_clause;
+    callback_slot<void (*)(void* data, int32_t fixed)> fixed;
+};
+
+std::mutex contexts_mutex;
+std::unordered_map<void*, std::unique_ptr<traced_solver>> contexts;
+
+traced_solver* context(void* solver, bool create) {
+    std::lock_guard<std::mutex> lock(contexts_mutex);
+    auto it = contexts.find(solver);
+    if (it != contexts.end()) {
+        return it->second.get();
+    }
+    if (!create) {
+        return nullptr;
+    }
+    traced_solver* ctx = new traced_solver();
+    ctx->solver = solver;
+    contexts.emplace(solver, std::unique_ptr<traced_solver>(ctx));
+    return ctx;
+}
+
+int terminate_trampoline(void* data) {
+    traced_solver* ctx = static_cast<traced_solver*>(data);
+    auto binding = ctx->terminate.load();
+    if (binding == nullptr) {
+        return 0;
+    }
+    ++ctx->polls;
+    uint64_t start = now();
+    ++callback_depth;
+    int ret = binding->callback(binding->data);
+    if (ret != 0) {
+        record(IPASIR2_TRACE_CB_TERMINATE, ctx->solver, IPASIR2_E_OK, start, now()).put(static_cast<int32_t>(ret)).put(static_cast<int64_t>(ctx->polls));
+    }
+    --callback_depth;
+    return ret;
+}
+
+void export_trampoline(void* data, int32_t const* clause, int32_t len, void* proofmeta) {
+    traced_solver* ctx = static_cast<traced_solver*>(data);
+    auto binding = ctx->export_clause.load();
+    if (binding == nullptr) {
+        return;
+    }
+    uint64_t start = now();
+    ++callback_depth;
+    binding->callback(binding->data, clause, len, proofmeta);
+    record(IPASIR2_TRACE_CB_EXPORT, ctx->solver, IPASIR2_E_OK, start, now()).put(len).put(clause, len);
+    --callback_depth;
+}
+
+void export_batch_trampoline(void* data, int32_t const* literals, int32_t const* offsets, int32_t count, void* const* proofmeta) {
+    traced_solver* ctx = static_cast<traced_solver*>(data);
+    auto binding = ctx->export_batch.load();
+    if (binding == nullptr) {
+        return;
+    }
+    uint64_t start = now();
+    ++callback_depth;
+    binding->callback(binding->data, literals, offsets, count, proofmeta);
+    record r(IPASIR2_TRACE_CB_EXPORT_BATCH, ctx->solver, IPASIR2_E_OK, start, now());
+    r.put(count).put(offsets, count + 1);
+    if (count > 0) {
+        r.put(literals + offsets[0], offsets[count] - offsets[0]);
+    }
+    --callback_depth;
+}
+
+void delete_trampoline(void* data, int32_t const* clause, int32_t len, void* proofmeta) {
+    traced_solver* ctx = static_cast<traced_solver*>(data);
+    auto binding = ctx->delete_clause.load();
+    if (binding == nullptr) {
+        return;
+    }
+    uint64_t start = now();
+    ++callback_depth;
+    binding->callback(binding->data, clause, len, proofmeta);
+    record(IPASIR2_TRACE_CB_DELETE, ctx->solver, IPASIR2_E_OK, start, now()).put(len).put(clause, len);
+    --callback_depth;
+}
+
+void import_trampoline(void* data) {
+    traced_solver* ctx = static_cast<traced_solver*>(data);
+    auto binding = ctx->import_clause.load();
+    if (binding == nullptr) {
+        return;
+    }
+    uint64_t start = now();
+    ++callback_depth;
+    binding->callback(binding->data);
+    record(IPASIR2_TRACE_CB_IMPORT, ctx->solver, IPASIR2_E_OK, start, now());
+    --callback_depth;
+}
+
+void fixed_trampoline(void* data, int32_t fixed) {
+    traced_solver* ctx = static_cast<traced_solver*>(data);
+    auto binding = ctx->fixed.load();
+    if (binding == nullptr) {
+        return;
+    }
+    uint64_t start = now();
+    ++callback_depth;
+    binding->callback(binding->data, fixed);
+    record(IPASIR2_TRACE_CB_FIXED, ctx->solver, IPASIR2_E_OK, start, now()).put(fixed);
+    --callback_depth;
+}
+}
+
+
+extern "C" {
+
+IPASIR_API ipasir2_errorcode ipasir2_signature(char const** signature) {
+    uint64_t start = now();
+    ipasir2_errorcode ret = real().signature(signature);
+    record(IPASIR2_TRACE_SIGNATURE, nullptr, ret, start, now());
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_init(void** solver) {
+    uint64_t start = now();
+    ipasir2_errorcode ret = real().init(solver);
+    record(IPASIR2_TRACE_INIT, ret == IPASIR2_E_OK ? *solver : nullptr, ret, start, now());
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_release(void* solver) {
+    uint64_t start = now();
+    ipasir2_errorcode ret = real().release(solver);
+    record(IPASIR2_TRACE_RELEASE, solver, ret, start, now());
+    if (ret == IPASIR2_E_OK) {
+        std::lock_guard<std::mutex> lock(contexts_mutex);
+        contexts.erase(solver);
+    }
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_clone(void* solver, void** clone) {
+    uint64_t start = now();
+    ipasir2_errorcode ret = forward(real().clone, solver, clone);
+    int64_t copy = ret == IPASIR2_E_OK ? static_cast<int64_t>(reinterpret_cast<uintptr_t>(*clone)) : 0;
+    record(IPASIR2_TRACE_CLONE, solver, ret, start, now()).put(copy);
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_options(void* solver, ipasir2_option const** options, int* count) {
+    uint64_t start = now();
+    ipasir2_errorcode ret = forward(real().options, solver, options, count);
+    record(IPASIR2_TRACE_OPTIONS, solver, ret, start);
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_set_option(void* solver, ipasir2_option const* handle, int64_t value, int64_t index) {
+    uint64_t start = now();
+    ipasir2_errorcode ret = forward(real().set_option, solver, handle, value, index);
+    record(IPASIR2_TRACE_SET_OPTION, solver, ret, start).put_string(handle != nullptr ? handle->name : nullptr).put(value).put(index);
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_set_option_array(void* solver, ipasir2_option const* handle, int64_t const* values,
+    int64_t const* indices, int64_t first, int32_t count) {
+    uint64_t start = now();
+    ipasir2_errorcode ret = forward(real().set_option_array, solver, handle, values, indices, first, count);
+    record(IPASIR2_TRACE_SET_OPTION_ARRAY, solver, ret, start, now())
+        .put_string(handle != nullptr ? handle->name : nullptr).put(first).put(count).put(static_cast<int32_t>(indices != nullptr))
+        .put(values, count).put(indices, count);
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_add(void* solver, int32_t const* clause, int32_t len, int32_t forgettable, void* proofmeta) {
+    uint64_t start = now();
+    ipasir2_errorcode ret = real().add(solver, clause, len, forgettable, proofmeta);
+    record(IPASIR2_TRACE_ADD, solver, ret, start).put(forgettable).put(len).put(clause, len);
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_add_clauses(void* solver, int32_t const* literals, int32_t const* offsets, int32_t count,
+    int32_t forgettable, void* const* proofmeta) {
+    uint64_t start = now();
+    ipasir2_errorcode ret = forward(real().add_clauses, solver, literals, offsets, count, forgettable, proofmeta);
+    record r(IPASIR2_TRACE_ADD_CLAUSES, solver, ret, start, now());
+    r.put(forgettable).put(count);
+    if (count > 0) {
+        r.put(offsets, count + 1).put(literals + offsets[0], offsets[count] - offsets[0]);
+    }
+    else {
+        int32_t zero = 0;
+        r.put(zero);
+    }
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_solve(void* solver, int* result, int32_t const* literals, int32_t len) {
+    traced_solver* ctx = context(solver, false);
+    if (ctx != nullptr) {
+        ctx->polls = 0;
+    }
+    uint64_t start = now();
+    ipasir2_errorcode ret = real().solve(solver, result, literals, len);
+    record(IPASIR2_TRACE_SOLVE, solver, ret, start, now()).put(static_cast<int32_t>(ret == IPASIR2_E_OK ? *result : 0)).put(len).put(literals, len);
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_value(void* solver, int32_t lit, int32_t* result) {
+    uint64_t start = now();
+    ipasir2_errorcode ret = forward(real().value, solver, lit, result);
+    record(IPASIR2_TRACE_VALUE, solver, ret, start).put(lit).put(ret == IPASIR2_E_OK ? *result : 0);
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_values(void* solver, int32_t first, int32_t count, int8_t* result) {
+    uint64_t start = now();
+    ipasir2_errorcode ret = forward(real().values, solver, first, count, result);
+    record(IPASIR2_TRACE_VALUES, solver, ret, start, now()).put(first).put(count);
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_failed(void* solver, int32_t lit, int* result) {
+    uint64_t start = now();
+    ipasir2_errorcode ret = forward(real().failed, solver, lit, result);
+    record(IPASIR2_TRACE_FAILED, solver, ret, start).put(lit).put(static_cast<int32_t>(ret == IPASIR2_E_OK ? *result : 0));
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_failed_core(void* solver, int32_t* core, int32_t capacity, int32_t* size) {
+    uint64_t start = now();
+    ipasir2_errorcode ret = forward(real().failed_core, solver, core, capacity, size);
+    record(IPASIR2_TRACE_FAILED_CORE, solver, ret, start, now()).put(capacity).put(ret == IPASIR2_E_OK ? *size : 0);
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_set_terminate(void* solver, void* data, int (*callback)(void* data)) {
+    uint64_t start = now();
+    traced_solver* ctx = context(solver, true);
+    ipasir2_errorcode ret = forward(real().set_terminate, solver, static_cast<void*>(ctx), callback != nullptr ? terminate_trampoline : nullptr);
+    if (ret == IPASIR2_E_OK) {
+        ctx->terminate.store(data, callback);
+    }
+    record(IPASIR2_TRACE_SET_TERMINATE, solver, ret, start).put(static_cast<int32_t>(callback != nullptr));
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_set_export(void* solver, void* data, int max_length,
+    void (*callback)(void* data, int32_t const* clause, int32_t len, void* proofmeta)) {
+    uint64_t start = now();
+    traced_solver* ctx = context(solver, true);
+    ipasir2_errorcode ret = forward(real().set_export, solver, static_cast<void*>(ctx), max_length, callback != nullptr ? export_trampoline : nullptr);
+    if (ret == IPASIR2_E_OK) {
+        ctx->export_clause.store(data, callback);
+    }
+    record(IPASIR2_TRACE_SET_EXPORT, solver, ret, start).put(static_cast<int32_t>(callback != nullptr)).put(static_cast<int32_t>(max_length));
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_set_export_batch(void* solver, void* data, int max_length,
+    void (*callback)(void* data, int32_t const* literals, int32_t const* offsets, int32_t count, void* const* proofmeta)) {
+    uint64_t start = now();
+    traced_solver* ctx = context(solver, true);
+    ipasir2_errorcode ret = forward(real().set_export_batch, solver, static_cast<void*>(ctx), max_length, callback != nullptr ? export_batch_trampoline : nullptr);
+    if (ret == IPASIR2_E_OK) {
+        ctx->export_batch.store(data, callback);
+    }
+    record(IPASIR2_TRACE_SET_EXPORT_BATCH, solver, ret, start).put(static_cast<int32_t>(callback != nullptr)).put(static_cast<int32_t>(max_length));
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_set_delete(void* solver, void* data,
+    void (*callback)(void* data, int32_t const* clause, int32_t len, void* proofmeta)) {
+    uint64_t start = now();
+    traced_solver* ctx = context(solver, true);
+    ipasir2_errorcode ret = forward(real().set_delete, solver, static_cast<void*>(ctx), callback != nullptr ? delete_trampoline : nullptr);
+    if (ret == IPASIR2_E_OK) {
+        ctx->delete_clause.store(data, callback);
+    }
+    record(IPASIR2_TRACE_SET_DELETE, solver, ret, start).put(static_cast<int32_t>(callback != nullptr));
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_set_import(void* solver, void* data, void (*callback)(void* data)) {
+    uint64_t start = now();
+    traced_solver* ctx = context(solver, true);
+    ipasir2_errorcode ret = forward(real().set_import, solver, static_cast<void*>(ctx), callback != nullptr ? import_trampoline : nullptr);
+    if (ret == IPASIR2_E_OK) {
+        ctx->import_clause.store(data, callback);
+    }
+    record(IPASIR2_TRACE_SET_IMPORT, solver, ret, start).put(static_cast<int32_t>(callback != nullptr));
+    return ret;
+}
+
+IPASIR_API ipasir2_errorcode ipasir2_set_fixed(void* solver, void* data, void (*callback)(void* data, int32_t fixed)) {
+    uint64_t start = now();
+    traced_solver* ctx = context(solver, true);
+    ipasir2_errorcode ret = forward(real().set_fixed, solver, static_cast<void*>(ctx), callback != nullptr ? fixed_trampoline : nullptr);
+    if (ret == IPASIR2_E_OK) {
+        ctx->fixed.store(data, callback);
+    }
+    record(IPASIR2_TRACE_SET_FIXED, solver, ret, start).put(static_cast<int32_t>(callback != nullptr));
+    return ret;
+}
+
+}
@@ -0,0 +1,106 @@
+/**
+ * MIT License
+ *
+ * Binary format of IPASIR-2 call traces, written by the ipasir2_trace library
+ * and read by the replay client.
+ *
+ * A trace file starts with an ipasir2_trace_file_header, followed by chunks.
+ * Each chunk starts with an ipasir2_trace_chunk_header and contains the records
+ * of a single thread in call order. Chunks of different threads are interleaved
+ * in the order in which they were flushed. All values are in host byte order.
+ *
+ * Each record starts with an ipasir2_trace_record_header, followed by a payload
+ * depending on the function. Records are written when a call returns, so the
+ * records of callbacks invoked during ipasir2_solve() (flag IPASIR2_TRACE_IN_CALLBACK),
+ * including the ipasir2_add() calls made from import callbacks, precede the record
+ * of the ipasir2_solve() call they belong to.
+ *
+ * Payloads (i32 = int32_t, i64 = int64_t, str = i32 length followed by the characters):
+ *   SIGNATURE, INIT, RELEASE, OPTIONS: empty
+ *   CLONE:             i64 clone, the new solver instance (0 if the call failed)
+ *   SET_OPTION:        str name, i64 value, i64 index
+ *   SET_OPTION_ARRAY:  str name, i64 first, i32 count, i32 has_indices, i64 values[count], i64 indices[count] if has_indices
+ *   ADD:               i32 forgettable, i32 len, i32 clause[len]
+ *   ADD_CLAUSES:       i32 forgettable, i32 count, i32 offsets[count + 1], i32 literals[offsets[count] - offsets[0]]
+ *   SOLVE:             i32 result, i32 len, i32 assumptions[len]
+ *   VALUE:             i32 lit, i32 result
+ *   VALUES:            i32 first, i32 count
+ *   FAILED:            i32 lit, i32 result
+ *   FAILED_CORE:       i32 capacity, i32 size
+ *   SET_TERMINATE, SET_DELETE, SET_IMPORT, SET_FIXED: i32 enabled
+ *   SET_EXPORT, SET_EXPORT_BATCH: i32 enabled, i32 max_length
+ *   CB_TERMINATE:      i32 returned value, i64 number of terminate polls in this solve call
+ *   CB_EXPORT, CB_DELETE: i32 len, i32 clause[len]
+ *   CB_EXPORT_BATCH:   i32 count, i32 offsets[count + 1], i32 literals[offsets[count] - offsets[0]]
+ *   CB_IMPORT:         empty
+ *   CB_FIXED:          i32 lit
+ *
+ * CB_TERMINATE records are only written for polls returning a non-zero value.
+ * The duration of cheap calls (OPTIONS, SET_OPTION, ADD, VALUE, FAILED, SET_*) is not measured and recorded as 0.
+ *
+ */
+
+#ifndef IPASIR2_TRACE_FORMAT_H
+#define IPASIR2_TRACE_FORMAT_H
+
+#include <stdint.h>
+
+#define IPASIR2_TRACE_MAGIC "IP2TRACE"
+#define IPASIR2_TRACE_VERSION 1
+#define IPASIR2_TRACE_CHUNK_MAGIC 0x4b4e4843u  // "CHNK"
+
+#define IPASIR2_TRACE_IN_CALLBACK 1
+
+typedef enum ipasir2_trace_function {
+    IPASIR2_TRACE_SIGNATURE = 1,
+    IPASIR2_TRACE_INIT,
+    IPASIR2_TRACE_RELEASE,
+    IPASIR2_TRACE_OPTIONS,
+    IPASIR2_TRACE_SET_OPTION,
+    IPASIR2_TRACE_SET_OPTION_ARRAY,
+    IPASIR2_TRACE_ADD,
+    IPASIR2_TRACE_ADD_CLAUSES,
+    IPASIR2_TRACE_SOLVE,
+    IPASIR2_TRACE_VALUE,
+    IPASIR2_TRACE_VALUES,
+    IPASIR2_TRACE_FAILED,
+    IPASIR2_TRACE_FAILED_CORE,
+    IPASIR2_TRACE_SET_TERMINATE,
+    IPASIR2_TRACE_SET_EXPORT,
+    IPASIR2_TRACE_SET_DELETE,
+    IPASIR2_TRACE_SET_IMPORT,
+    IPASIR2_TRACE_SET_FIXED,
+    IPASIR2_TRACE_SET_EXPORT_BATCH,
+    IPASIR2_TRACE_CLONE,
+
+    IPASIR2_TRACE_CB_TERMINATE = 64,
+    IPASIR2_TRACE_CB_EXPORT,
+    IPASIR2_TRACE_CB_DELETE,
+    IPASIR2_TRACE_CB_IMPORT,
+    IPASIR2_TRACE_CB_FIXED,
+    IPASIR2_TRACE_CB_EXPORT_BATCH,
+} ipasir2_trace_function;
+
+typedef struct ipasir2_trace_file_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+} ipasir2_trace_file_header;
+
+typedef struct ipasir2_trace_chunk_header {
+    uint32_t magic;
+    uint32_t thread;    // sequential number of the recording thread
+    uint64_t size;      // number of bytes of records following this header
+} ipasir2_trace_chunk_header;
+
+typedef struct ipasir2_trace_record_header {
+    uint8_t function;   // ipasir2_trace_function
+    uint8_t flags;      // IPASIR2_TRACE_IN_CALLBACK
+    uint16_t reserved;
+    int32_t error;      // returned ipasir2_errorcode, zero for callbacks
+    uint64_t timestamp; // monotonic clock at the start of the call, in nanoseconds
+    uint64_t duration;  // duration of the call in nanoseconds, 0 for cheap calls which are not timed
+    uint64_t solver;    // solver instance, as returned by ipasir2_init()
+} ipasir2_trace_record_header;
+
+#endif // IPASIR2_TRACE_FORMAT_H
@@ -0,0 +1,238 @@
+/**
+ * MIT License
+ *
+ * Reader for IPASIR-2 call traces written by the ipasir2_trace library (see trace_format.h).
+ *
+ * The whole trace is loaded into memory and split into the record sequences of the
+ * recording threads. Payloads are decoded on demand with trace_payload.
+ *
+ */
+
+#ifndef IPASIR2_TRACE_READER_H
+#define IPASIR2_TRACE_READER_H
+
+#include <stdio.h>
+#include <string.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "trace_format.h"
+
+
+struct trace_record {
+    ipasir2_trace_record_header header;
+    char const* payload;
+    size_t size;
+};
+
+
+/**
+ * Sequential decoder of one record payload. Values are copied out, since payloads are not aligned.
+ */
+class trace_payload {
+public:
+    explicit trace_payload(trace_record const& record) : m_pos(record.payload), m_end(record.payload + record.size) {}
+
+    template<typename T>
+    T get() {
+        T value;
+        take(&value, sizeof(T));
+        return value;
+    }
+
+    template<typename T>
+    void get(std::vector<T>& values, int32_t count) {
+        values.resize(count > 0 ? count : 0);
+        take(values.data(), sizeof(T) * values.size());
+    }
+
+    // length or count field, which must not be negative
+    size_t get_length() {
+        int32_t len = get<int32_t>();
+        if (len < 0) {
+            throw std::runtime_error("Corrupt trace record");
+        }
+        return len;
+    }
+
+    std::string get_string() {
+        std::string str(get_length(), '\0');
+        take(&str[0], str.size());
+        return str;
+    }
+
+private:
+    void take(void* data, size_t size) {
+        if (static_cast<size_t>(m_end - m_pos) < size) {
+            throw std::runtime_error("Truncated trace record");
+        }
+        if (size > 0) {
+            memcpy(data, m_pos, size);
+        }
+        m_pos += size;
+    }
+
+    char const* m_pos;
+    char const* m_end;
+};
+
+
+class trace_reader {
+public:
+    explicit trace_reader(char const* path) {
+        std::unique_ptr<FILE, int(*)(FILE*)> file(fopen(path, "rb"), fclose);
+        if (!file) {
+            throw std::runtime_error(std::string("Cannot open trace file ") + path);
+        }
+        char block[1 << 16];
+        size_t n;
+        while ((n = fread(block, 1, sizeof(block), file.get())) > 0) {
+            m_data.insert(m_data.end(), block, block + n);
+        }
+
+        ipasir2_trace_file_header header;
+        if (m_data.size() < sizeof(header)) {
+            throw std::runtime_error("Not an IPASIR-2 trace file");
+        }
+        memcpy(&header, m_data.data(), sizeof(header));
+        if (memcmp(header.magic, IPASIR2_TRACE_MAGIC, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("Not an IPASIR-2 trace file");
+        }
+        if (header.version != IPASIR2_TRACE_VERSION) {
+            throw std::runtime_error("Unsupported trace format version " + std::to_string(header.version));
+        }
+
+        char const* pos = m_data.data() + sizeof(header);
+        char const* end = m_data.data() + m_data.size();
+        while (pos < end) {
+            ipasir2_trace_chunk_header chunk;
+            if (static_cast<size_t>(end - pos) < sizeof(chunk)) {
+                throw std::runtime_error("Truncated trace chunk");
+            }
+            memcpy(&chunk, pos, sizeof(chunk));
+            pos += sizeof(chunk);
+            if (chunk.magic != IPASIR2_TRACE_CHUNK_MAGIC || chunk.size > static_cast<size_t>(end - pos)) {
+                throw std::runtime_error("Corrupt trace chunk");
+            }
+            if (chunk.thread >= m_threads.size()) {
+                m_threads.resize(chunk.thread + 1);
+            }
+            read_chunk(m_threads[chunk.thread], pos, pos + chunk.size);
+            pos += chunk.size;
+        }
+    }
+
+    // records of each recording thread, in call order
+    std::vector<std::vector<trace_record>> const& threads() const {
+        return m_threads;
+    }
+
+    size_t records() const {
+        size_t count = 0;
+        for (auto const& thread : m_threads) {
+            count += thread.size();
+        }
+        return count;
+    }
+
+private:
+    void read_chunk(std::vector<trace_record>& records, char const* pos, char const* end) {
+        while (pos < end) {
+            trace_record record;
+            if (static_cast<size_t>(end - pos) < sizeof(record.header)) {
+                throw std::runtime_error("Truncated trace record");
+            }
+            memcpy(&record.header, pos, sizeof(record.header));
+            pos += sizeof(record.header);
+            record.payload = pos;
+            record.size = end - pos;
+            record.size = payload_size(record);
+            pos += record.size;
+            records.push_back(record);
+        }
+    }
+
+    // decodes the length fields of the payload, see trace_format.h
+    static size_t payload_size(trace_record const& record) {
+        trace_payload p(record);
+        size_t size = 0;
+        switch (record.header.function) {
+            case IPASIR2_TRACE_SIGNATURE:
+            case IPASIR2_TRACE_INIT:
+            case IPASIR2_TRACE_RELEASE:
+            case IPASIR2_TRACE_OPTIONS:
+            case IPASIR2_TRACE_CB_IMPORT:
+                break;
+            case IPASIR2_TRACE_SET_OPTION:
+                size = 4 + p.get_length() + 16;
+                break;
+            case IPASIR2_TRACE_SET_OPTION_ARRAY: {
+                size_t len = p.get_string().size();
+                p.get<int64_t>();
+                size_t count = p.get_length();
+                int32_t has_indices = p.get<int32_t>();
+                size = 4 + len + 16 + 8 * count * (has_indices ? 2 : 1);
+                break;
+            }
+            case IPASIR2_TRACE_ADD:
+            case IPASIR2_TRACE_SOLVE:
+                p.get<int32_t>();
+                size = 8 + 4 * p.get_length();
+                break;
+            case IPASIR2_TRACE_ADD_CLAUSES:
+            case IPASIR2_TRACE_CB_EXPORT_BATCH: {
+                size_t fields = record.header.function == IPASIR2_TRACE_ADD_CLAUSES ? 2 : 1;
+                if (fields == 2) {
+                    p.get<int32_t>();
+                }
+                size_t count = p.get_length();
+                int32_t first = p.get<int32_t>();
+                int32_t last = first;
+                for (size_t i = 0; i < count; ++i) {
+                    last = p.get<int32_t>();
+                }
+                if (last < first) {
+                    throw std::runtime_error("Corrupt trace record");
+                }
+                size = 4 * fields + 4 * (count + 1) + 4 * static_cast<size_t>(last - first);
+                break;
+            }
+            case IPASIR2_TRACE_VALUE:
+            case IPASIR2_TRACE_VALUES:
+            case IPASIR2_TRACE_FAILED:
+            case IPASIR2_TRACE_FAILED_CORE:
+            case IPASIR2_TRACE_SET_EXPORT:
+            case IPASIR2_TRACE_SET_EXPORT_BATCH:
+            case IPASIR2_TRACE_CLONE:
+                size = 8;
+                break;
+            case IPASIR2_TRACE_SET_TERMINATE:
+            case IPASIR2_TRACE_SET_DELETE:
+            case IPASIR2_TRACE_SET_IMPORT:
+            case IPASIR2_TRACE_SET_FIXED:
+            case IPASIR2_TRACE_CB_FIXED:
+                size = 4;
+                break;
+            case IPASIR2_TRACE_CB_TERMINATE:
+                size = 12;
+                break;
+            case IPASIR2_TRACE_CB_EXPORT:
+            case IPASIR2_TRACE_CB_DELETE:
+                size = 4 + 4 * p.get_length();
+                break;
+            default:
+                throw std::runtime_error("Unknown trace record type " + std::to_string(record.header.function));
+        }
+        if (size > record.size) {
+            throw std::runtime_error("Truncated trace record");
+        }
+        return size;
+    }
+
+    std::vector<char> m_data;
+    std::vector<std::vector<trace_record>> m_threads;
+};
+
+#endif // IPASIR2_TRACE_READER_H